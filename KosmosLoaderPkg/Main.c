@@ -12,6 +12,9 @@
 #include "frame_buffer_config.hpp"
 #include "elf.hpp"
 
+// shadow buffer + layer 버퍼 등, 화면 몇 장 분량의 RAM을 커널에 넘길지
+#define kGraphicsMemoryScreens 4
+
 // #@@range_begin(struct_memory_map)
 struct MemoryMap {
 	UINTN buffer_size;
@@ -379,6 +382,21 @@ EFI_STATUS EFIAPI UefiMain(
 	}
 	// #@@range_end(copy_segments)
 
+	// #@@range_begin(alloc_graphics_memory)
+	/* 커널의 shadow buffer 등 화면 크기의 RAM 버퍼용 영역 확보
+	커널에는 아직 메모리 관리 기능이 없으므로 boot service가 살아있을 때 확보해서 넘김
+	위치는 상관없음 -> AllocateAnyPages / 커널의 모든 그리기가 이 영역을 쓰므로 실패하면 정지 */
+	EFI_PHYSICAL_ADDRESS graphics_memory = 0;
+	UINTN graphics_memory_size = kGraphicsMemoryScreens * 4 *
+		gop->Mode->Info->PixelsPerScanLine * gop->Mode->Info->VerticalResolution;
+	status = gBS->AllocatePages(AllocateAnyPages, EfiLoaderData,
+		(graphics_memory_size + 0xfff) / 0x1000, &graphics_memory);
+	if (EFI_ERROR(status)) {
+		Print(L"failed to allocate graphics memory: %r\n", status);
+		Halt();
+	}
+	// #@@range_end(alloc_graphics_memory)
+
 	
 	// #@@range_begin(exit_bs)
 	/* ExitBootServices()는 최신 메모리 맵의 맵 키 요구
@@ -417,7 +435,9 @@ EFI_STATUS EFIAPI UefiMain(
 		gop->Mode->Info->PixelsPerScanLine,
 		gop->Mode->Info->HorizontalResolution,
 		gop->Mode->Info->VerticalResolution,
-		0
+		0,
+		(UINT8*)graphics_memory,
+		graphics_memory_size
 	};
 	
 	switch (gop->Mode->Info->PixelFormat) {
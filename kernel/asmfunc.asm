@@ -23,6 +23,20 @@ IoIn32:
 	in eax, dx ; System V AMD64 사양 -> rax: 함수의 반환 값
 	ret
 
+; COM1 (16550 UART) 등 8bit 레지스터의 장치용
+global IoOut8 ; void IoOut8(uint16_t addr, uint8_t data);
+IoOut8:
+	mov dx, di ; dx = addr
+	mov al, sil ; al = data (rsi의 하위 8비트)
+	out dx, al
+	ret
+
+global IoIn8 ; uint8_t IoIn8(uint16_t addr);
+IoIn8:
+	mov dx, di ; dx = addr
+	in al, dx
+	ret
+
 global GetCS  ; uint16_t GetCS(void);
 GetCS:
     xor eax, eax  ; also clears upper 32 bits of rax
@@ -43,4 +57,31 @@ LoadIDT:
     mov rsp, rbp
     pop rbp
     ret
-; #@@range_end(load_idt_function)
\ No newline at end of file
+; #@@range_end(load_idt_function)
+
+; #@@range_begin(enable_avx_function)
+; CR4.OSXSAVE (bit 18)를 켜고 XCR0에 x87, SSE, AVX 상태 (bit 0~2)를 추가
+; -> AVX (VEX 256bit) 명령 사용 가능, CPUID의 OSXSAVE bit도 1이 됨
+global EnableAVX  ; void EnableAVX(void);
+EnableAVX:
+    mov rax, cr4
+    or rax, 1 << 18
+    mov cr4, rax
+    xor ecx, ecx
+    xgetbv  ; edx:eax = XCR0
+    or eax, 0x7
+    xsetbv
+    ret
+; #@@range_end(enable_avx_function)
+
+; #@@range_begin(write_msr_function)
+; MSR (Model Specific Register) msr에 value 쓰기: wrmsr은 ecx = 번호, edx:eax = 값
+global WriteMSR  ; void WriteMSR(uint32_t msr, uint64_t value);
+WriteMSR:
+    mov ecx, edi
+    mov eax, esi
+    mov rdx, rsi
+    shr rdx, 32
+    wrmsr
+    ret
+; #@@range_end(write_msr_function)
\ No newline at end of file
@@ -0,0 +1,128 @@
+/* BitBlt 행 kernel microbenchmark (호스트에서 실행, make bench)
+화면 크기 이미지를 kernel마다, 모드마다 반복 복사해 MB/s (대상 기준 바이트) 출력
+측정 전에 SIMD kernel 결과가 1픽셀씩 계산한 기대값과 같은지 확인 */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "blit.hpp"
+
+namespace {
+	const int kWidth = 1920, kHeight = 1080;
+
+	uint32_t ExpectedBlend(uint32_t d, uint32_t s) {
+		const uint32_t a = s >> 24;
+		uint32_t result = 0;
+		for (int shift = 0; shift < 32; shift += 8) {
+			const uint32_t sc = (s >> shift) & 0xffu, dc = (d >> shift) & 0xffu;
+			result |= ((sc * a + dc * (255 - a) + 127) / 255) << shift;
+		}
+		return result;
+	}
+
+	// 모드마다 특징이 나오는 원본: color key는 절반이 key, alpha는 불투명/투명/반투명이 섞임
+	std::vector<uint32_t> MakeSource(BlitMode mode, uint32_t key) {
+		std::vector<uint32_t> src(kWidth * kHeight);
+		srand(1);
+		for (auto& p : src) {
+			p = static_cast<uint32_t>(rand()) & 0xffffffu;
+			if (mode == BlitMode::kColorKey && rand() % 2) {
+				p = key;
+			} else if (mode == BlitMode::kAlpha) {
+				const int r = rand() % 4;
+				p |= (r == 0 ? 0u : r == 1 ? 255u : static_cast<uint32_t>(rand() % 256)) << 24;
+			}
+		}
+		return src;
+	}
+
+	void RunRows(const BlitKernels& k, BlitMode mode, uint32_t* dst, const uint32_t* src,
+	             int width, int height, uint32_t key) {
+		for (int y = 0; y < height; ++y) {
+			switch (mode) {
+			case BlitMode::kOpaque: k.opaque(dst, src, width); break;
+			case BlitMode::kColorKey: k.color_key(dst, src, width, key); break;
+			case BlitMode::kAlpha: k.alpha(dst, src, width); break;
+			}
+			dst += kWidth;
+			src += kWidth;
+		}
+	}
+
+	bool Verify(const BlitKernels& k, BlitMode mode, uint32_t key) {
+		const auto src = MakeSource(mode, key);
+		std::vector<uint32_t> dst(kWidth * kHeight), expected(kWidth * kHeight);
+		for (int i = 0; i < kWidth * kHeight; ++i) {
+			dst[i] = expected[i] = static_cast<uint32_t>(i * 2654435761u);
+			const uint32_t s = src[i];
+			if (mode == BlitMode::kOpaque || (mode == BlitMode::kColorKey && s != key)) {
+				expected[i] = s;
+			} else if (mode == BlitMode::kAlpha) {
+				expected[i] = ExpectedBlend(expected[i], s);
+			}
+		}
+		// 폭을 조금씩 바꿔 SIMD 폭으로 나누어떨어지지 않는 나머지 처리도 확인
+		const int width = kWidth - 3;
+		RunRows(k, mode, dst.data(), src.data(), width, kHeight, key);
+		for (int y = 0; y < kHeight; ++y) {
+			for (int x = 0; x < width; ++x) {
+				if (dst[kWidth * y + x] != expected[kWidth * y + x]) {
+					printf("%s: mismatch at (%d, %d)\n", k.name, x, y);
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	void Bench(const BlitKernels& k, BlitMode mode, const char* mode_name, int width, int height) {
+		const uint32_t key = 0x00ff00ffu;
+		const auto src = MakeSource(mode, key);
+		std::vector<uint32_t> dst(kWidth * kHeight);
+		const double bytes = 4.0 * width * height;
+		const int iterations = static_cast<int>(4e9 / bytes / 8) + 1; // 약 0.5GB분
+		RunRows(k, mode, dst.data(), src.data(), width, height, key); // page fault, 캐시 준비
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; ++i) {
+			RunRows(k, mode, dst.data(), src.data(), width, height, key);
+		}
+		const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		printf("%-5s %-9s %4dx%-4d %10.1f MB/s %10.1f Mpixels/s\n", k.name, mode_name, width, height,
+		       bytes * iterations / sec / 1e6, bytes / 4 * iterations / sec / 1e6);
+	}
+}
+
+int main() {
+	std::vector<const BlitKernels*> kernels{&kSSE2BlitKernels};
+	if (CpuCanUseAVX2()) {
+		kernels.push_back(&kAVX2BlitKernels);
+	} else {
+		printf("avx2: not available on this CPU, skipped\n");
+	}
+
+	const struct {
+		BlitMode mode;
+		const char* name;
+	} modes[] = {
+		{BlitMode::kOpaque, "opaque"},
+		{BlitMode::kColorKey, "color_key"},
+		{BlitMode::kAlpha, "alpha"},
+	};
+
+	for (auto k : kernels) {
+		for (const auto& m : modes) {
+			if (!Verify(*k, m.mode, 0x00ff00ffu)) {
+				return 1;
+			}
+		}
+	}
+	for (const auto& m : modes) {
+		for (auto k : kernels) {
+			Bench(*k, m.mode, m.name, kWidth, kHeight); // 화면 전체 (캐시에 들어가지 않음)
+			Bench(*k, m.mode, m.name, 64, 64);          // 아이콘, 커서 크기 (캐시 안)
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,103 @@
+/* 화면 합성 회귀 검사 (호스트에서 실행, make test)
+gfx_bench와 같은 구성 (shadow buffer + 바탕화면, 콘솔 layer + 마우스 커서)에 콘솔 위의 작은 layer를 더해서
+콘솔 출력, 스크롤 (PageUp/PageDown 포함), 커서 이동마다 Render + Flush한 VRAM이
+전체를 처음부터 다시 합성한 결과와 같은지 확인 -> 바뀐 부분만 그리는 최적화가 빠뜨린 영역 검출 */
+
+#include <cstdint>
+#include <cstdio>
+#include <new>
+#include <vector>
+
+#include "console.hpp"
+#include "frame_buffer.hpp"
+#include "layer.hpp"
+#include "mouse.hpp"
+#include "window.hpp"
+
+namespace {
+	const int kWidth = 640, kHeight = 480;
+
+	std::vector<uint32_t> vram(kWidth * kHeight);
+	std::vector<uint8_t> graphics_memory(6 * 4 * kWidth * kHeight + 4096);
+	FrameBuffer screen;
+	Window desktop_window, console_window, overlay_window;
+	LayerManager layers;
+	alignas(Console) char console_buf[sizeof(Console)];
+	alignas(MouseCursor) char mouse_cursor_buf[sizeof(MouseCursor)];
+}
+
+int main() {
+	FrameBufferConfig config{};
+	config.frame_buffer = reinterpret_cast<uint8_t*>(vram.data());
+	config.pixels_per_scan_line = kWidth;
+	config.horizontal_resolution = kWidth;
+	config.vertical_resolution = kHeight;
+	config.pixel_format = kPixelBGRResv8BitPerColor;
+	InitializeGraphicsMemory(graphics_memory.data(), graphics_memory.size());
+	if (auto err = screen.Initialize(config)) {
+		printf("compose_test: screen.Initialize: %s\n", err.Name());
+		return 1;
+	}
+
+	// 콘솔은 화면 가장자리에서 떨어뜨려 놓음 -> layer 위치 offset도 확인
+	desktop_window.Initialize(kWidth, kHeight, config.pixel_format);
+	console_window.Initialize(kWidth - 40, kHeight - 60, config.pixel_format);
+	overlay_window.Initialize(100, 50, config.pixel_format);
+	desktop_window.Writer().FillRectangle({0, 0}, {kWidth, kHeight}, {45, 118, 237});
+	console_window.Writer().FillRectangle({0, 0}, {kWidth - 40, kHeight - 60}, {0, 0, 0});
+	overlay_window.Writer().FillRectangle({0, 0}, {100, 50}, {200, 0, 0});
+
+	layers.SetScreen(&screen);
+	auto desktop_id = layers.NewLayer()->SetWindow(&desktop_window).Move({0, 0}).ID();
+	auto console_id = layers.NewLayer()->SetWindow(&console_window).Move({20, 20}).ID();
+	auto overlay_id = layers.NewLayer()->SetWindow(&overlay_window).Move({300, 200}).ID();
+	layers.UpDown(desktop_id, 0);
+	layers.UpDown(console_id, 1);
+	layers.UpDown(overlay_id, 2);
+	layer_manager = &layers;
+
+	auto console = new(console_buf) Console{console_window.Writer(), {255, 255, 255}, {0, 0, 0}};
+	console->SetLayerID(console_id);
+	layers.Draw({{0, 0}, {kWidth, kHeight}});
+	auto mouse_cursor = new(mouse_cursor_buf) MouseCursor{&screen, {200, 150}};
+	layers.SetSprite(&mouse_cursor->GetSprite());
+	screen.Flush();
+
+	int mismatches = 0;
+	for (int i = 0; i < 300; ++i) {
+		char line[64];
+		snprintf(line, sizeof(line), "line %d %s\n", i, i % 3 ? "abc" : "xyzxyzxyzxyzxyzxyzxyz");
+		console->PutString(line);
+		if (i % 7 == 0) {
+			console->PutString("two\nlines\n"); // 한 frame에 여러 줄 스크롤
+		}
+		if (i == 150) {
+			console->Scroll(5);
+		} else if (i == 151) {
+			console->Scroll(-2);
+		} else if (i == 160) {
+			console->ScrollToBottom();
+		}
+		if (i % 11 == 0) { // 커서가 콘솔과 위 layer를 지나가도록
+			mouse_cursor->MoveRelative({3, 2});
+			mouse_cursor->Render();
+		}
+		console->Render();
+		screen.Flush();
+
+		const std::vector<uint32_t> rendered = vram;
+		layers.Draw({{0, 0}, {kWidth, kHeight}});
+		screen.Flush();
+		if (rendered != vram) {
+			if (mismatches++ < 5) {
+				printf("compose_test: frame %d differs from a full recomposite\n", i);
+			}
+		}
+	}
+	if (mismatches) {
+		printf("compose_test: %d of 300 frames differ\n", mismatches);
+		return 1;
+	}
+	printf("compose_test: ok\n");
+	return 0;
+}
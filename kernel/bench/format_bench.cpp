@@ -0,0 +1,117 @@
+/* 커널 printf (format.cpp)와 C 라이브러리 vsnprintf 비교 (호스트에서 실행, make bench)
+커널의 log에 실제로 있는 줄들로 ns/line 출력 (5회 측정의 중앙값)
+  buffer: 1KiB 버퍼에 포맷 (vsnprintf / FormatToBuffer)
+  log ring: 이전 방식 (1KiB 버퍼에 포맷 -> LogRing::Write 복사) / 현재 방식 (최대 길이로 Reserve -> 바로 포맷 -> Commit에서 반납)
+측정 전에 모든 줄의 출력이 vsnprintf와 같은지 확인
+호스트의 vsnprintf는 glibc (커널이 쓰던 newlib과 구현은 다름) */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "format.hpp"
+#include "log_ring.hpp"
+
+namespace {
+	const int kLines = 200000;
+	const int kRepeats = 5;
+
+	LogRing ring;
+	char drain_buf[LogRing::kMaxRecord];
+
+	struct RecordContext {
+		char* pos;
+		char* end;
+	};
+
+	void RecordSink(void* context, const char* s, size_t len) {
+		auto c = static_cast<RecordContext*>(context);
+		const size_t n = len < static_cast<size_t>(c->end - c->pos) ? len : c->end - c->pos;
+		memcpy(c->pos, s, n);
+		c->pos += n;
+	}
+
+	// logger.cpp의 VWriteLog와 같은 방식
+	void RingFormat(const char* format, ...) __attribute__((format(printf, 1, 2)));
+	void RingFormat(const char* format, ...) {
+		va_list ap;
+		va_start(ap, format);
+		if (char* record = ring.Reserve(LogRing::kMaxRecord)) { // 측정 중 ring은 가득 차지 않음
+			RecordContext context{record, record + LogRing::kMaxRecord};
+			VFormat(RecordSink, &context, format, ap);
+			ring.Commit(record, context.pos - record);
+		}
+		va_end(ap);
+	}
+
+	// 이전 printk, LogMessage와 같은 방식
+	void RingVsnprintf(const char* format, ...) __attribute__((format(printf, 1, 2)));
+	void RingVsnprintf(const char* format, ...) {
+		char s[1024];
+		va_list ap;
+		va_start(ap, format);
+		const int result = vsnprintf(s, sizeof(s), format, ap);
+		va_end(ap);
+		ring.Write(s, result > 0 ? std::min<size_t>(result, sizeof(s) - 1) : 0);
+	}
+
+	// f(i)는 i번째 줄 출력
+	template <typename F>
+	double Measure(F f) {
+		std::vector<double> ns_per_line;
+		for (int r = 0; r < kRepeats; ++r) {
+			const auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < kLines; ++i) {
+				f(i);
+				if (i % 32 == 31) { // main loop의 DrainLog처럼 ring 비우기 (log ring 측정 이외에는 비어 있음)
+					while (ring.Read(drain_buf, sizeof(drain_buf))) {
+					}
+				}
+			}
+			const auto elapsed = std::chrono::steady_clock::now() - start;
+			ns_per_line.push_back(std::chrono::duration<double, std::nano>(elapsed).count() / kLines);
+		}
+		std::sort(ns_per_line.begin(), ns_per_line.end());
+		return ns_per_line[kRepeats / 2];
+	}
+
+	char out[1024];
+	volatile size_t sink_bytes; // 최적화로 포맷이 사라지지 않게
+
+	// 각 줄: 이름, 그리고 (buffer vsnprintf, FormatToBuffer, ring vsnprintf, ring Format)을 같은 인자로
+#define BENCH_LINE(name, format, ...) \
+	{ \
+		const int i = 7; /* 확인용 인자 */ \
+		char expected[1024], actual[1024]; \
+		snprintf(expected, sizeof(expected), format, __VA_ARGS__); \
+		FormatToBuffer(actual, sizeof(actual), format, __VA_ARGS__); \
+		if (strcmp(expected, actual) != 0) { \
+			printf("MISMATCH %s: [%s] vs [%s]\n", name, expected, actual); \
+			return 1; \
+		} \
+		const double libc = Measure([&](int i) { \
+			sink_bytes += snprintf(out, sizeof(out), format, __VA_ARGS__); }); \
+		const double kernel = Measure([&](int i) { \
+			sink_bytes += FormatToBuffer(out, sizeof(out), format, __VA_ARGS__); }); \
+		const double ring_libc = Measure([&](int i) { RingVsnprintf(format, __VA_ARGS__); }); \
+		const double ring_kernel = Measure([&](int i) { RingFormat(format, __VA_ARGS__); }); \
+		printf("%-22s %10.1f %10.1f %10.1f %10.1f\n", name, libc, kernel, ring_libc, ring_kernel); \
+	}
+}
+
+int main() {
+	printf("%-22s %10s %10s %10s %10s  (ns/line)\n", "line",
+	       "vsnprintf", "Format", "ring+vsn", "ring+Fmt");
+	BENCH_LINE("welcome %s", "Welcome to %s!\n", "KosmOS");
+	BENCH_LINE("mmio base %08lx", "xHC mmio_base = %08lx\n", 0xfebf0000ul + (i & 0xf0));
+	BENCH_LINE("pci device", "%d.%d.%d: vend %04x, class %02x%02x%02x, head %02x\n",
+	           0, i & 31, 0, 0x8086, 0x0c, 0x03, 0x30, 0x80);
+	BENCH_LINE("error %s at %s:%d", "Error while ProcessEvent: %s at %s:%d\n",
+	           "kTransferFailed", "usb/xhci/xhci.cpp", 100 + (i & 127));
+	BENCH_LINE("dropped %lu", "[log: %lu messages dropped]\n", static_cast<unsigned long>(i));
+	return sink_bytes == 0;
+}
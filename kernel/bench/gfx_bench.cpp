@@ -0,0 +1,142 @@
+/* 그리기, 콘솔, 마우스 커서 benchmark (호스트에서 실행, make bench)
+커널과 같은 코드를 메모리 상의 FrameBufferConfig (가짜 VRAM + graphics memory)에 대해 실행
+RGB, BGR writer 각각 ns/op, Mpixels/s 출력 (5회 측정의 중앙값)
++ 1회당 쓴 픽셀, VRAM flush 바이트 (render_counters) -> 다시 그리는 양이 늘어나는 회귀 확인용 */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <new>
+#include <vector>
+
+#include "console.hpp"
+#include "font.hpp"
+#include "frame_buffer.hpp"
+#include "graphics.hpp"
+#include "layer.hpp"
+#include "mouse.hpp"
+#include "window.hpp"
+
+namespace {
+	const int kWidth = 1920, kHeight = 1080;
+	const int kRepeats = 5;
+
+	// 커널의 KernelMain과 같은 구성: shadow buffer + 바탕화면, 콘솔 layer + 마우스 커서
+	struct Desktop {
+		std::vector<uint32_t> vram;
+		std::vector<uint8_t> graphics_memory;
+		FrameBuffer screen;
+		Window desktop_window, console_window;
+		LayerManager layers;
+		alignas(Console) char console_buf[sizeof(Console)];
+		Console* console;
+		alignas(MouseCursor) char mouse_cursor_buf[sizeof(MouseCursor)];
+		MouseCursor* mouse_cursor;
+
+		explicit Desktop(PixelFormat format)
+				: vram(kWidth * kHeight), graphics_memory(4 * 4 * kWidth * kHeight + 4096) {
+			FrameBufferConfig config{};
+			config.frame_buffer = reinterpret_cast<uint8_t*>(vram.data());
+			config.pixels_per_scan_line = kWidth;
+			config.horizontal_resolution = kWidth;
+			config.vertical_resolution = kHeight;
+			config.pixel_format = format;
+			InitializeGraphicsMemory(graphics_memory.data(), graphics_memory.size());
+			screen.Initialize(config);
+
+			desktop_window.Initialize(kWidth, kHeight, format);
+			console_window.Initialize(kWidth, kHeight - 30, format);
+			desktop_window.Writer().FillRectangle({0, 0}, {kWidth, kHeight}, {45, 118, 237});
+			console_window.Writer().FillRectangle({0, 0}, {kWidth, kHeight - 30}, {45, 118, 237});
+
+			layers.SetScreen(&screen);
+			auto desktop_id = layers.NewLayer()->SetWindow(&desktop_window).Move({0, 0}).ID();
+			auto console_id = layers.NewLayer()->SetWindow(&console_window).Move({0, 0}).ID();
+			layers.UpDown(desktop_id, 0);
+			layers.UpDown(console_id, 1);
+			layer_manager = &layers;
+
+			console = new(console_buf) Console{
+				console_window.Writer(), {255, 255, 255}, {45, 118, 237}};
+			console->SetLayerID(console_id);
+			layers.Draw({{0, 0}, {kWidth, kHeight}});
+			mouse_cursor = new(mouse_cursor_buf) MouseCursor{&screen, {300, 200}};
+			layers.SetSprite(&mouse_cursor->GetSprite());
+			screen.Flush();
+		}
+	};
+
+	template <typename F>
+	void Run(const char* format_name, const char* name, int ops, double pixels_per_op, F op) {
+		op(); // page fault, 캐시, 글꼴 캐시 준비
+		const RenderCounters before = render_counters;
+		std::vector<double> ns_per_op;
+		for (int r = 0; r < kRepeats; ++r) {
+			const auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < ops; ++i) {
+				op();
+			}
+			const auto elapsed = std::chrono::steady_clock::now() - start;
+			ns_per_op.push_back(std::chrono::duration<double, std::nano>(elapsed).count() / ops);
+		}
+		std::sort(ns_per_op.begin(), ns_per_op.end());
+		const double ns = ns_per_op[kRepeats / 2];
+		const double runs = static_cast<double>(kRepeats) * ops;
+		printf("%-3s %-36s %12.1f ns/op %10.1f Mpixels/s %10.0f px/op %10.0f flush B/op\n",
+		       format_name, name, ns, pixels_per_op / ns * 1e3,
+		       (render_counters.pixels_written - before.pixels_written) / runs,
+		       (render_counters.flush_bytes - before.flush_bytes) / runs);
+	}
+
+	void BenchFormat(PixelFormat format, const char* format_name) {
+		alignas(Desktop) static char desktop_buf[sizeof(Desktop)];
+		auto desktop = new(desktop_buf) Desktop{format};
+		PixelWriter& writer = desktop->screen.Writer();
+
+		Run(format_name, "FillRectangle 1920x1080 (shadow)", 200, kWidth * kHeight, [&] {
+			writer.FillRectangle({0, 0}, {kWidth, kHeight}, {12, 34, 56});
+		});
+		desktop->screen.Flush();
+
+		char line[241];
+		for (int i = 0; i < 240; ++i) {
+			line[i] = '!' + i % 90;
+		}
+		line[240] = '\0';
+		int y = 0;
+		Run(format_name, "WriteString 240 chars", 2000, 240 * 8 * 16, [&] {
+			WriteString(writer, 0, y, line, {255, 255, 255});
+			y = (y + 16) % (kHeight - 16);
+		});
+		desktop->screen.Flush();
+
+		// 200자 줄 1개 출력 + 최하단 스크롤 + layer 재합성 + VRAM flush
+		line[200] = '\n';
+		line[201] = '\0';
+		for (int i = 0; i < 100; ++i) {
+			desktop->console->PutString(line);
+		}
+		Run(format_name, "Console line + scroll + render/flush", 200,
+		    static_cast<double>(kWidth) * (kHeight - 30), [&] {
+			desktop->console->PutString(line);
+			desktop->console->Render();
+			desktop->screen.Flush();
+		});
+
+		int step = 0;
+		Run(format_name, "Cursor move + flush", 20000, 2 * kMouseCursorWidth * kMouseCursorHeight, [&] {
+			const int d = (step++ / 200) % 2 ? -3 : 3; // 화면 안에서 왕복
+			desktop->mouse_cursor->MoveRelative({d, d});
+			desktop->mouse_cursor->Render();
+			desktop->screen.Flush();
+		});
+
+		desktop->~Desktop();
+	}
+}
+
+int main() {
+	BenchFormat(kPixelRGBResv8BitPerColor, "RGB");
+	BenchFormat(kPixelBGRResv8BitPerColor, "BGR");
+	return 0;
+}
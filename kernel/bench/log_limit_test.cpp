@@ -0,0 +1,150 @@
+/* LogLimiter (log_limit.cpp) 회귀 검사 (호스트에서 실행, make test)
+burst, window가 끝난 뒤의 요약과 재시작, Flush, site 표가 가득 찼을 때의 재사용
+now는 TSC 대신 직접 넘기는 값 -> 시간에 의존하지 않음 */
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "log_limit.hpp"
+
+namespace {
+	int failures = 0;
+
+#define CHECK(cond) \
+	do { \
+		if (!(cond)) { \
+			printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+			++failures; \
+		} \
+	} while (0)
+
+	struct Report {
+		const char* file;
+		int line;
+		uint64_t repeated;
+	};
+	std::vector<Report> reports;
+
+	void Record(const char* file, int line, uint64_t repeated) {
+		reports.push_back({file, line, repeated});
+	}
+
+	const char kFile[] = "xhci.cpp";
+	const uint64_t kWindow = 1000;
+
+	// 처음 kBurst개만 통과, 나머지는 세기만 함 (요약은 아직 X)
+	void TestBurst() {
+		reports.clear();
+		LogLimiter limiter{Record};
+		limiter.SetWindow(kWindow);
+		for (uint32_t i = 0; i < LogLimiter::kBurst; ++i) {
+			CHECK(limiter.Check(kFile, 10, i));
+		}
+		for (int i = 0; i < 7; ++i) {
+			CHECK(!limiter.Check(kFile, 10, 100 + i));
+		}
+		CHECK(reports.empty());
+		CHECK(limiter.Suppressed() == 7);
+		CHECK(limiter.SiteAt(0).logged == LogLimiter::kBurst);
+		CHECK(limiter.SiteAt(0).pending == 7);
+
+		// 다른 site는 따로 셈
+		CHECK(limiter.Check(kFile, 20, 200));
+		CHECK(limiter.SiteAt(1).line == 20);
+	}
+
+	// window가 끝난 뒤의 첫 Check: 지난 window의 요약 출력 + 다시 kBurst개 통과
+	void TestWindowReset() {
+		reports.clear();
+		LogLimiter limiter{Record};
+		limiter.SetWindow(kWindow);
+		for (uint32_t i = 0; i < LogLimiter::kBurst + 3; ++i) {
+			limiter.Check(kFile, 10, 0);
+		}
+		CHECK(!limiter.Check(kFile, 10, kWindow - 1)); // 아직 같은 window
+		CHECK(reports.empty());
+
+		CHECK(limiter.Check(kFile, 10, kWindow));
+		CHECK(reports.size() == 1);
+		if (reports.size() == 1) {
+			CHECK(reports[0].file == kFile && reports[0].line == 10 && reports[0].repeated == 4);
+		}
+		CHECK(limiter.SiteAt(0).window_start == kWindow);
+		CHECK(limiter.SiteAt(0).pending == 0);
+		for (uint32_t i = 1; i < LogLimiter::kBurst; ++i) {
+			CHECK(limiter.Check(kFile, 10, kWindow + i));
+		}
+		CHECK(!limiter.Check(kFile, 10, kWindow + 10));
+
+		// 억제 없이 window가 끝나면 요약 X
+		reports.clear();
+		LogLimiter quiet{Record};
+		quiet.SetWindow(kWindow);
+		CHECK(quiet.Check(kFile, 30, 0));
+		CHECK(quiet.Check(kFile, 30, 5 * kWindow));
+		CHECK(reports.empty());
+	}
+
+	// 반복이 멈춘 site: window가 끝난 뒤의 Flush에서 1번만 요약
+	void TestFlush() {
+		reports.clear();
+		LogLimiter limiter{Record};
+		limiter.SetWindow(kWindow);
+		for (uint32_t i = 0; i < LogLimiter::kBurst + 2; ++i) {
+			limiter.Check(kFile, 10, 0);
+		}
+		limiter.Check(kFile, 20, 0); // 억제 없음
+
+		limiter.Flush(kWindow - 1);
+		CHECK(reports.empty());
+		limiter.Flush(kWindow);
+		CHECK(reports.size() == 1);
+		if (reports.size() == 1) {
+			CHECK(reports[0].line == 10 && reports[0].repeated == 2);
+		}
+		limiter.Flush(2 * kWindow);
+		CHECK(reports.size() == 1);
+		CHECK(limiter.Suppressed() == 2); // 누계는 그대로
+	}
+
+	// site가 가득 차면 가장 오래 전에 window를 시작한 site를 요약 후 재사용
+	void TestEviction() {
+		reports.clear();
+		LogLimiter limiter{Record};
+		limiter.SetWindow(kWindow);
+		for (int i = 0; i < LogLimiter::kSites; ++i) {
+			limiter.Check(kFile, 100 + i, 10 + i);
+		}
+		for (uint32_t i = 1; i < LogLimiter::kBurst; ++i) { // 위의 1개 포함 kBurst개
+			limiter.Check(kFile, 101, 50);
+		}
+		CHECK(!limiter.Check(kFile, 101, 50)); // line 101 (window_start = 11): 억제 1
+
+		// line 100 (window_start = 10)이 가장 오래됨 -> 억제가 없으니 요약 없이 재사용
+		CHECK(limiter.Check(kFile, 200, 60));
+		CHECK(reports.empty());
+		CHECK(limiter.SiteAt(0).line == 200);
+
+		// 다음은 line 101 -> 남은 억제 수를 요약한 뒤 재사용
+		CHECK(limiter.Check(kFile, 201, 70));
+		CHECK(reports.size() == 1);
+		if (reports.size() == 1) {
+			CHECK(reports[0].line == 101 && reports[0].repeated == 1);
+		}
+		CHECK(limiter.SiteAt(1).line == 201);
+	}
+}
+
+int main() {
+	TestBurst();
+	TestWindowReset();
+	TestFlush();
+	TestEviction();
+	if (failures) {
+		printf("log_limit_test: %d failures\n", failures);
+		return 1;
+	}
+	printf("log_limit_test: ok\n");
+	return 0;
+}
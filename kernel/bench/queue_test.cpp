@@ -0,0 +1,143 @@
+/* SPSCQueue (queue.hpp) 회귀 검사 (호스트에서 실행, make test)
+비었을 때, 가득 찼을 때 (N개), 위치가 N을 여러 바퀴 넘는 wraparound, batch의 일부만 들어가는 경우
++ 생산자, 소비자 thread 2개로 순서와 누락 확인 (커널의 interrupt handler -> main loop와 같은 구성) */
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+#include "queue.hpp"
+
+namespace {
+	int failures = 0;
+
+#define CHECK(cond) \
+	do { \
+		if (!(cond)) { \
+			printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+			++failures; \
+		} \
+	} while (0)
+
+	const size_t kN = 8;
+
+	void TestEmptyAndFull() {
+		std::array<int, kN> buf;
+		SPSCQueue<int> queue{buf};
+		int value = -1;
+		CHECK(queue.Capacity() == kN);
+		CHECK(queue.Count() == 0);
+		CHECK(queue.Pop(value).Cause() == Error::kEmpty);
+		CHECK(value == -1);
+
+		for (size_t i = 0; i < kN; ++i) {
+			CHECK(!queue.Push(static_cast<int>(i)));
+		}
+		CHECK(queue.Count() == kN);
+		CHECK(queue.Push(100).Cause() == Error::kFull);
+		CHECK(queue.PushBatch(&value, 1) == 0);
+		CHECK(queue.Count() == kN);
+
+		for (size_t i = 0; i < kN; ++i) {
+			CHECK(!queue.Pop(value));
+			CHECK(value == static_cast<int>(i));
+		}
+		CHECK(queue.Count() == 0);
+		CHECK(queue.Pop(value).Cause() == Error::kEmpty);
+	}
+
+	// 위치는 줄지 않고 계속 증가 -> 여러 바퀴 돌아도 순서, Count가 맞는지
+	void TestWraparound() {
+		std::array<int, kN> buf;
+		SPSCQueue<int> queue{buf};
+		int next_push = 0, next_pop = 0;
+		for (int round = 0; round < 100; ++round) {
+			const size_t pushes = 1 + round % kN;
+			for (size_t i = 0; i < pushes; ++i) {
+				CHECK(!queue.Push(next_push++));
+			}
+			CHECK(queue.Count() == pushes);
+			int values[kN];
+			const size_t popped = queue.PopBatch(values, kN);
+			CHECK(popped == pushes);
+			for (size_t i = 0; i < popped; ++i) {
+				CHECK(values[i] == next_pop++);
+			}
+		}
+		CHECK(queue.Count() == 0);
+	}
+
+	// 자리보다 큰 batch는 앞에서부터 들어가는 만큼만, 꺼낼 때도 max개까지
+	void TestPartialBatch() {
+		std::array<int, kN> buf;
+		SPSCQueue<int> queue{buf};
+		int values[kN + 4];
+		for (size_t i = 0; i < kN + 4; ++i) {
+			values[i] = static_cast<int>(i);
+		}
+		CHECK(queue.PushBatch(values, 3) == 3);
+		CHECK(queue.PushBatch(values + 3, kN + 1) == kN - 3);
+		CHECK(queue.Count() == kN);
+
+		int out[kN];
+		CHECK(queue.PopBatch(out, 5) == 5);
+		for (int i = 0; i < 5; ++i) {
+			CHECK(out[i] == i);
+		}
+		CHECK(queue.PushBatch(values + kN, 4) == 4); // 끝을 넘어 앞쪽 칸으로
+		CHECK(queue.PopBatch(out, kN) == kN - 1);
+		for (size_t i = 0; i < kN - 1; ++i) {
+			CHECK(out[i] == static_cast<int>(5 + i));
+		}
+		CHECK(queue.PopBatch(out, kN) == 0);
+	}
+
+	// 생산자가 넣은 값이 빠짐, 중복, 순서 바뀜 없이 소비자에게 도착하는지
+	void TestTwoThreads() {
+		const uint64_t kItems = 200000;
+		std::array<uint64_t, kN> buf;
+		SPSCQueue<uint64_t> queue{buf};
+		std::thread producer{[&] {
+			uint64_t next = 0;
+			while (next < kItems) {
+				uint64_t batch[3] = {next, next + 1, next + 2};
+				const size_t count = kItems - next < 3 ? kItems - next : 3;
+				const size_t pushed = queue.PushBatch(batch, count);
+				if (pushed == 0) {
+					std::this_thread::yield(); // CPU가 1개인 호스트에서도 소비자가 진행하도록
+				}
+				next += pushed;
+			}
+		}};
+		uint64_t expected = 0;
+		bool in_order = true;
+		while (expected < kItems) {
+			uint64_t values[kN];
+			const size_t n = queue.PopBatch(values, 5);
+			if (n == 0) {
+				std::this_thread::yield();
+			}
+			for (size_t i = 0; i < n; ++i) {
+				in_order = in_order && values[i] == expected;
+				++expected;
+			}
+		}
+		producer.join();
+		CHECK(in_order);
+		CHECK(queue.Count() == 0);
+	}
+}
+
+int main() {
+	TestEmptyAndFull();
+	TestWraparound();
+	TestPartialBatch();
+	TestTwoThreads();
+	if (failures) {
+		printf("queue_test: %d failures\n", failures);
+		return 1;
+	}
+	printf("queue_test: ok\n");
+	return 0;
+}
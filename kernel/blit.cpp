@@ -0,0 +1,233 @@
+#include "blit.hpp"
+
+#include <cpuid.h>
+#include <immintrin.h>
+
+namespace {
+	// #@@range_begin(blend_scalar)
+	/* 채널마다 (s * a + d * (255 - a)) / 255, a = src의 예약 바이트
+	/255는 t = x + 128 -> (t + (t >> 8)) >> 8 로 반올림까지 정확히 계산 (SIMD kernel과 같은 결과) */
+	uint32_t BlendPixel(uint32_t d, uint32_t s) {
+		const uint32_t a = s >> 24;
+		uint32_t result = 0;
+		for (int shift = 0; shift < 32; shift += 8) {
+			const uint32_t t = ((s >> shift) & 0xffu) * a + ((d >> shift) & 0xffu) * (255 - a) + 128;
+			result |= ((t + (t >> 8)) >> 8) << shift;
+		}
+		return result;
+	}
+
+	void ColorKeyTail(uint32_t* dst, const uint32_t* src, size_t count, uint32_t key) {
+		for (size_t i = 0; i < count; ++i) {
+			if (src[i] != key) {
+				dst[i] = src[i];
+			}
+		}
+	}
+
+	void AlphaTail(uint32_t* dst, const uint32_t* src, size_t count) {
+		for (size_t i = 0; i < count; ++i) {
+			dst[i] = BlendPixel(dst[i], src[i]);
+		}
+	}
+	// #@@range_end(blend_scalar)
+
+	// #@@range_begin(blit_sse2)
+	void ColorKeySSE2(uint32_t* dst, const uint32_t* src, size_t count, uint32_t key) {
+		const __m128i k = _mm_set1_epi32(key);
+		for (; count >= 4; count -= 4, dst += 4, src += 4) {
+			const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+			const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst));
+			const __m128i eq = _mm_cmpeq_epi32(s, k); // key인 픽셀은 d, 나머지는 s
+			const __m128i r = _mm_or_si128(_mm_and_si128(eq, d), _mm_andnot_si128(eq, s));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), r);
+		}
+		ColorKeyTail(dst, src, count, key);
+	}
+
+	// 16bit로 펼친 채널 (픽셀 2개분)을 BlendPixel과 같은 식으로 합성
+	__m128i Blend16SSE2(__m128i s, __m128i d) {
+		// 각 픽셀의 alpha (4번째 word)를 그 픽셀의 4개 word 모두로 복사
+		const __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, 0xff), 0xff);
+		const __m128i inv_a = _mm_sub_epi16(_mm_set1_epi16(255), a);
+		__m128i t = _mm_add_epi16(_mm_mullo_epi16(s, a), _mm_mullo_epi16(d, inv_a));
+		t = _mm_add_epi16(t, _mm_set1_epi16(128));
+		return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+	}
+
+	void AlphaSSE2(uint32_t* dst, const uint32_t* src, size_t count) {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i alpha_mask = _mm_set1_epi32(0xff000000);
+		for (; count >= 4; count -= 4, dst += 4, src += 4) {
+			const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+			const __m128i a = _mm_and_si128(s, alpha_mask);
+			// 4픽셀 모두 불투명 / 투명이면 합성 없이 복사 / 건너뜀 (커서, 아이콘은 대부분 이 경우)
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(a, alpha_mask)) == 0xffff) {
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), s);
+				continue;
+			}
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(a, zero)) == 0xffff) {
+				continue;
+			}
+			const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst));
+			const __m128i lo = Blend16SSE2(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero));
+			const __m128i hi = Blend16SSE2(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(lo, hi));
+		}
+		AlphaTail(dst, src, count);
+	}
+	// #@@range_end(blit_sse2)
+
+	// #@@range_begin(blit_avx2)
+	const size_t kLongSpan = 256;
+
+	/* AVX2 판: 같은 처리를 256bit (8픽셀) 단위로
+	unpack, shuffle, pack은 128bit lane마다 동작하지만 lo/hi 양쪽에 같은 순서로 적용되므로 결과 순서는 유지 */
+	__attribute__((target("avx2")))
+	void OpaqueAVX2(uint32_t* dst, const uint32_t* src, size_t count) {
+		// 긴 행은 rep movs가 더 빠름 (fast string), 짧은 행만 기동 비용이 없는 256bit 복사
+		if (count >= kLongSpan) {
+			CopySpan32(dst, src, count);
+			return;
+		}
+		for (; count >= 8; count -= 8, dst += 8, src += 8) {
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst),
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)));
+		}
+		for (size_t i = 0; i < count; ++i) {
+			dst[i] = src[i];
+		}
+	}
+
+	__attribute__((target("avx2")))
+	void ColorKeyAVX2(uint32_t* dst, const uint32_t* src, size_t count, uint32_t key) {
+		const __m256i k = _mm256_set1_epi32(key);
+		for (; count >= 8; count -= 8, dst += 8, src += 8) {
+			const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+			const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst));
+			const __m256i eq = _mm256_cmpeq_epi32(s, k);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_blendv_epi8(s, d, eq));
+		}
+		ColorKeyTail(dst, src, count, key);
+	}
+
+	__attribute__((target("avx2")))
+	__m256i Blend16AVX2(__m256i s, __m256i d) {
+		const __m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s, 0xff), 0xff);
+		const __m256i inv_a = _mm256_sub_epi16(_mm256_set1_epi16(255), a);
+		__m256i t = _mm256_add_epi16(_mm256_mullo_epi16(s, a), _mm256_mullo_epi16(d, inv_a));
+		t = _mm256_add_epi16(t, _mm256_set1_epi16(128));
+		return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+	}
+
+	__attribute__((target("avx2")))
+	void AlphaAVX2(uint32_t* dst, const uint32_t* src, size_t count) {
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i alpha_mask = _mm256_set1_epi32(0xff000000);
+		for (; count >= 8; count -= 8, dst += 8, src += 8) {
+			const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+			const __m256i a = _mm256_and_si256(s, alpha_mask);
+			if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(a, alpha_mask)) == -1) {
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), s);
+				continue;
+			}
+			if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(a, zero)) == -1) {
+				continue;
+			}
+			const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst));
+			const __m256i lo = Blend16AVX2(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero));
+			const __m256i hi = Blend16AVX2(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_packus_epi16(lo, hi));
+		}
+		AlphaTail(dst, src, count);
+	}
+	// #@@range_end(blit_avx2)
+
+	const BlitKernels* current_kernels = &kSSE2BlitKernels;
+}
+
+// #@@range_begin(blit_kernel_tables)
+// 불투명 복사는 SSE2 쪽에서 rep movs (CopySpan32)를 그대로 사용
+const BlitKernels kSSE2BlitKernels{"sse2", CopySpan32, ColorKeySSE2, AlphaSSE2};
+const BlitKernels kAVX2BlitKernels{"avx2", OpaqueAVX2, ColorKeyAVX2, AlphaAVX2};
+// #@@range_end(blit_kernel_tables)
+
+// #@@range_begin(blit_init)
+bool CpuSupportsAVX() {
+	unsigned int eax, ebx, ecx, edx;
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+		return false;
+	}
+	return (ecx & bit_XSAVE) && (ecx & bit_AVX);
+}
+
+bool CpuCanUseAVX2() {
+	unsigned int eax, ebx, ecx, edx;
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) ||
+	    !(ecx & bit_OSXSAVE) || !(ecx & bit_AVX)) {
+		return false;
+	}
+	// XCR0 bit 1 (SSE), bit 2 (AVX): OS가 XMM, YMM 레지스터 상태를 켰는지
+	uint32_t xcr0_low, xcr0_high;
+	__asm__ volatile("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0));
+	if ((xcr0_low & 0x6) != 0x6) {
+		return false;
+	}
+	if (__get_cpuid_max(0, nullptr) < 7) {
+		return false;
+	}
+	__cpuid_count(7, 0, eax, ebx, ecx, edx);
+	return ebx & bit_AVX2;
+}
+
+void InitializeBlit() {
+	current_kernels = CpuCanUseAVX2() ? &kAVX2BlitKernels : &kSSE2BlitKernels;
+}
+
+const BlitKernels& CurrentBlitKernels() {
+	return *current_kernels;
+}
+// #@@range_end(blit_init)
+
+// #@@range_begin(pixel_writer_bitblt)
+void PixelWriter::BitBlt(const Vector2D<int>& pos, const ImageView& src,
+		const Rectangle<int>& src_area, BlitMode mode, uint32_t color_key) {
+	// src 좌표 + offset = 대상 좌표, 이미지 범위와 clip으로 한 번씩만 자름
+	const Vector2D<int> offset{pos.x - src_area.pos.x, pos.y - src_area.pos.y};
+	const Rectangle<int> visible_src = src_area & Rectangle<int>{{0, 0}, {src.width, src.height}};
+	const Rectangle<int> rect =
+		Clip({visible_src.pos.x + offset.x, visible_src.pos.y + offset.y}, visible_src.size);
+	if (IsEmpty(rect)) {
+		return;
+	}
+	MarkDamaged(rect.pos, rect.size);
+
+	const BlitKernels& kernels = CurrentBlitKernels();
+	const uint32_t dst_stride = PixelsPerScanLine();
+	auto dst = reinterpret_cast<uint32_t*>(PixelAt(rect.pos.x, rect.pos.y));
+	auto p = src.pixels + src.stride * (rect.pos.y - offset.y) + (rect.pos.x - offset.x);
+	const size_t count = rect.size.x;
+	for (int dy = 0; dy < rect.size.y; ++dy) {
+		switch (mode) {
+		case BlitMode::kOpaque:
+			if (IsVideoMemory()) {
+				StreamCopySpan32(dst, p, count);
+			} else {
+				kernels.opaque(dst, p, count);
+			}
+			break;
+		case BlitMode::kColorKey:
+			kernels.color_key(dst, p, count, color_key);
+			break;
+		case BlitMode::kAlpha:
+			kernels.alpha(dst, p, count);
+			break;
+		}
+		dst += dst_stride;
+		p += src.stride;
+	}
+	if (IsVideoMemory() && mode == BlitMode::kOpaque) {
+		StreamFence();
+	}
+}
+// #@@range_end(pixel_writer_bitblt)
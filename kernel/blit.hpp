@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "graphics.hpp"
+
+/* BitBlt의 행 단위 kernel
+같은 연산을 SSE2 (x86-64 기본), AVX2 두 벌로 두고 InitializeBlit에서 CPU에 맞는 쪽을 선택
+-> PixelWriter::BitBlt는 선택된 kernel을 행마다 호출 */
+
+// #@@range_begin(blit_kernels)
+struct BlitKernels {
+	const char* name;
+	void (*opaque)(uint32_t* dst, const uint32_t* src, size_t count);
+	void (*color_key)(uint32_t* dst, const uint32_t* src, size_t count, uint32_t key);
+	void (*alpha)(uint32_t* dst, const uint32_t* src, size_t count);
+};
+
+extern const BlitKernels kSSE2BlitKernels;
+extern const BlitKernels kAVX2BlitKernels;
+// #@@range_end(blit_kernels)
+
+// #@@range_begin(blit_init)
+// CPU가 XSAVE, AVX를 지원하는지 (OS가 YMM 상태를 켰는지는 무관)
+bool CpuSupportsAVX();
+// CPU가 AVX2를 지원하고 OS가 YMM 상태 저장을 켰으면 true
+bool CpuCanUseAVX2();
+
+// CpuCanUseAVX2 결과로 kernel 선택 (AVX 활성화 후, 첫 BitBlt 전에 1회)
+void InitializeBlit();
+const BlitKernels& CurrentBlitKernels();
+// #@@range_end(blit_init)
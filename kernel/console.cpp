@@ -1,47 +1,182 @@
 #include "console.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include "font.hpp"
+#include "layer.hpp"
 
 // #@@range_begin(constructor)
 Console::Console(PixelWriter& writer,
 	const PixelColor& fg_color, const PixelColor& bg_color)
 	: writer_{writer}, fg_color_{fg_color}, bg_color_{bg_color},
-		buffer_{}, cursor_row_{0}, cursor_column_{0} { // buffer Null로 초기화
+		rows_{std::min(writer.Height() / GlyphCache::kHeight, kMaxRows)},
+		columns_{std::min(writer.Width() / GlyphCache::kWidth, kMaxColumns)},
+		history_{}, history_lines_{kHistoryBytes / sizeof(char16_t) / (columns_ + 1)},
+		head_line_{0}, cursor_row_{0}, cursor_column_{0}, scroll_offset_{0},
+		dirty_{}, drawn_top_line_{0}, layer_id_{0} { // history Null로 초기화
+	glyphs_.SetColors(writer_.GetPixelFormat(), fg_color_, bg_color_);
+	damage_.SetBounds({{0, 0}, {GlyphCache::kWidth * columns_, GlyphCache::kHeight * rows_}});
 }
 // #@@range_end(constructor)
 
 // #@@range_begin(put_string)
 void Console::PutString(const char* s) {
-	while (*s) {
-		if (*s == '\n') { // \n 만나면 Newline
-			Newline();
-		} else if (cursor_column_ < kColumns - 1) {
-			WriteAscii(writer_, 8 * cursor_column_, 16 * cursor_row_, *s, fg_color_);
-			buffer_[cursor_row_][cursor_column_] = *s;
-			++cursor_column_;
+	for (; *s; ++s) {
+		char32_t codes[2];
+		const int n = utf8_.Feed(static_cast<uint8_t>(*s), codes);
+		for (int i = 0; i < n; ++i) {
+			PutChar(codes[i]);
 		}
-		++s;
 	}
 }
+
+void Console::PutChar(char32_t code) {
+	if (code == U'\n') { // \n 만나면 Newline
+		Newline();
+		return;
+	}
+	if (code > 0xffff || code == kWideTail) { // 글꼴과 칸은 BMP만
+		code = Utf8Decoder::kReplacement;
+	}
+	const int cells = FindGlyph(code).width / GlyphCache::kWidth;
+	if (cursor_column_ + cells > columns_) { // 줄 끝을 넘는 글자는 버림
+		return;
+	}
+	char16_t* text = Line(head_line_);
+	text[cursor_column_] = static_cast<char16_t>(code);
+	if (cells == 2) {
+		text[cursor_column_ + 1] = kWideTail;
+	}
+	MarkDirty(head_line_, cursor_column_, cursor_column_ + cells); // 그리기는 Render에서
+	cursor_column_ += cells;
+}
 // #@@range_end(put_string)
 
+void Console::SetLayerID(unsigned int layer_id) {
+	layer_id_ = layer_id;
+}
+
+void Console::SetColors(const PixelColor& fg_color, const PixelColor& bg_color) {
+	fg_color_ = fg_color;
+	bg_color_ = bg_color;
+	glyphs_.SetColors(writer_.GetPixelFormat(), fg_color_, bg_color_);
+}
+
 // #@@range_begin(newline)
 void Console::Newline() {
 	cursor_column_ = 0;
-	if (cursor_row_ < kRows - 1) {
+	++head_line_;
+	memset(Line(head_line_), 0, sizeof(char16_t) * (columns_ + 1)); // ring이 가득 차면 가장 오래된 줄 자리를 재사용
+	Dirty(head_line_) = {0, 0};
+
+	if (cursor_row_ < rows_ - 1) {
 		++cursor_row_;
-	} else { // 커서가 최하단에 있을 때, 표시영역 전체를 올려서 스크롤 처리
-		for (int y = 0; y < 16 * kRows; ++y) { // 1. 표시영역 전체를 배격으로 채우기
-			for (int x = 0; x < 8 * kColumns; ++x) {
-				writer_.Write(x, y, bg_color_);
+	} else if (scroll_offset_ > 0) {
+		// 과거를 보는 중이면 같은 줄이 계속 보이도록 offset도 증가
+		// 보던 줄이 ring에서 밀려나면 가장 오래된 줄에서 멈춤
+		const int max_offset = static_cast<int>(head_line_ - cursor_row_ - OldestLine());
+		scroll_offset_ = std::min(scroll_offset_ + 1, max_offset);
+	}
+	// 최하단에서의 스크롤은 TopLine이 바뀌는 것뿐 -> 픽셀 이동은 Render에서 누적분을 한 번에
+}
+// #@@range_end(newline)
+
+void Console::MarkDirty(uint64_t line, int begin, int end) {
+	DirtySpan& span = Dirty(line);
+	if (span.begin >= span.end) {
+		span = {begin, end};
+	} else {
+		span.begin = std::min(span.begin, begin);
+		span.end = std::max(span.end, end);
+	}
+}
+
+// 배경까지 포함한 글꼴 전개 결과를 복사하므로 칸을 미리 지울 필요 X
+void Console::DrawLine(int row, uint64_t line, int begin, int end) {
+	const char16_t* text = line <= head_line_ ? Line(line) : nullptr; // 아직 출력 전인 줄은 공백
+	if (text && text[begin] == kWideTail) { // 전각 글자의 오른쪽 칸부터면 글자 전체를 그림
+		--begin;
+	}
+	const int y = GlyphCache::kHeight * row;
+	int column = begin;
+	while (column < end) {
+		const char16_t c = text && text[column] ? text[column] : u' ';
+		const GlyphCache::Image glyph = glyphs_.Get(c);
+		writer_.WriteImage({GlyphCache::kWidth * column, y},
+			glyph.pixels, glyph.width, GlyphCache::kHeight);
+		column += glyph.width / GlyphCache::kWidth;
+		++render_counters.glyphs_drawn;
+	}
+	damage_.Add({{GlyphCache::kWidth * begin, y},
+	             {GlyphCache::kWidth * (column - begin), GlyphCache::kHeight}});
+}
+
+// #@@range_begin(render)
+void Console::Render() {
+	const uint64_t top = TopLine();
+	const int line_height = GlyphCache::kHeight;
+	const int width = GlyphCache::kWidth * columns_;
+
+	// 1. 마지막으로 그린 뒤 표시 위치가 바뀌었으면 남는 부분은 픽셀 이동, 드러난 줄만 그리기
+	if (top != drawn_top_line_) {
+		const int64_t shift = static_cast<int64_t>(top - drawn_top_line_);
+		int first = 0, last = rows_; // 전체를 다시 그려야 하는 행 범위 [first, last)
+		Vector2D<int> dst_pos{0, 0};
+		Rectangle<int> src{{0, 0}, {0, 0}};
+		if (0 < shift && shift < rows_) { // 위로 shift줄 (새 출력, PageDown)
+			const int n = static_cast<int>(shift);
+			src = {{0, line_height * n}, {width, line_height * (rows_ - n)}};
+			first = rows_ - n;
+		} else if (0 < -shift && -shift < rows_) { // 아래로 (PageUp)
+			const int n = static_cast<int>(-shift);
+			dst_pos = {0, line_height * n};
+			src = {{0, 0}, {width, line_height * (rows_ - n)}};
+			last = n;
+		}
+		if (!IsEmpty(src)) {
+			// window와 화면에 이미 합성된 픽셀을 같이 이동 -> damage는 드러난 줄 (DrawLine)뿐
+			writer_.Move(dst_pos, src);
+			if (layer_manager) {
+				layer_manager->MoveArea(layer_id_, dst_pos, src);
 			}
 		}
-		for (int row = 0; row < kRows - 1; ++row) { // 2. 한줄 씩 buffer_내용 갱신, 랜더링
-			memcpy(buffer_[row], buffer_[row + 1], kColumns + 1);
-			WriteString(writer_, 0, 16 * row, buffer_[row], fg_color_);
+		for (int row = first; row < last; ++row) {
+			DrawLine(row, top + row, 0, columns_);
+		}
+		drawn_top_line_ = top;
+	}
+
+	// 2. 보이는 줄 중 바뀐 칸만 그리기 (화면 밖으로 나간 줄의 기록은 버림)
+	for (int row = 0; row < rows_; ++row) {
+		const DirtySpan& span = Dirty(top + row);
+		if (top + row <= head_line_ && span.begin < span.end) {
+			DrawLine(row, top + row, span.begin, span.end);
+		}
+	}
+	dirty_.fill({0, 0});
+
+	// 3. window에서 바뀐 영역만 화면에 다시 합성
+	if (layer_manager) {
+		for (int i = 0; i < damage_.Count(); ++i) {
+			layer_manager->Draw(layer_id_, damage_[i]);
 		}
-		memset(buffer_[kRows - 1], 0, kColumns + 1);
 	}
+	damage_.Clear();
 }
-// #@@range_end(newline)
+// #@@range_end(render)
+
+// #@@range_begin(scrollback)
+uint64_t Console::OldestLine() const {
+	return head_line_ < history_lines_ ? 0 : head_line_ - (history_lines_ - 1);
+}
+
+uint64_t Console::TopLine() const {
+	return head_line_ - cursor_row_ - scroll_offset_;
+}
+
+void Console::Scroll(int lines) {
+	// 최상단 줄이 보관 중인 가장 오래된 줄보다 앞으로 가지 않게 (다시 그리기는 Render에서)
+	const int max_offset = static_cast<int>(head_line_ - cursor_row_ - OldestLine());
+	scroll_offset_ = std::max(0, std::min(scroll_offset_ + lines, max_offset));
+}
+// #@@range_end(scrollback)
@@ -1,21 +1,77 @@
 #pragma once
 
+#include <array>
+
+#include "font.hpp"
+#include "frame_buffer.hpp"
 #include "graphics.hpp"
 
 /* 화면 하단 도달시, 한줄 씩 스크롤 기능 필요
 문자열 처음부터 살펴보다가, 줄바꿈 문자열을 만나면, (X좌표 = 0, Y좌표 += 16)
-스크롤: Complex: 화면을 한번 채워서 메시지 지우고, 한줄씩 내린 후, 다음 메시지 랜더링
-	-> 스크롤 전까지 표시된 메시지 기억 필요 */
+크기: 행, 열 수는 생성 시 writer (콘솔 window)의 크기에서 결정 (kMaxRows, kMaxColumns 이내)
+출력: PutString은 텍스트 기록 + 바뀐 칸 (행마다 열 범위) 표시만, 그리기는 Render에서 1회
+스크롤: 이미 그려진 픽셀 행을 누적된 줄 수만큼 한 번에 이동 + 드러난 줄만 그리기 (다시 랜더링 X)
+	화면에 합성된 픽셀도 LayerManager::MoveArea로 함께 이동 -> 재합성은 드러난 줄만
+텍스트: 고정 크기 원형 버퍼 (ring) -> 줄바꿈은 head 이동만, 행 복사 X
+	화면에서 밀려난 줄도 버퍼 크기만큼 남아 있어 PageUp/PageDown으로 되돌아볼 수 있음
+문자: PutString은 UTF-8, 칸마다 code point (BMP) 1개 -> 전각 글자 (한글 등)는 2칸 차지 */
 class Console {
 	public:
-		static const int kRows = 25, kColumns = 80;
+		static constexpr int kMaxRows = 256, kMaxColumns = 512; // 4K (3840x2160)까지 전체 사용
+		static constexpr size_t kHistoryBytes = 1024 * 1024; // 80열이면 약 6500줄, 480열이면 약 1000줄
 		Console(PixelWriter& writer, const PixelColor& fg_color, const PixelColor& bg_color);
 		void PutString(const char* s);
+		// 콘솔을 표시하는 layer: Render에서 이 layer의 바뀐 부분만 다시 합성
+		void SetLayerID(unsigned int layer_id);
+		// 바뀐 칸, 스크롤을 window에 그리고 화면에 반영 (출력마다가 아니라 frame당 1회)
+		void Render();
+		// 이후 출력부터 적용 (글꼴 캐시는 다음 출력 시 필요한 글자만 새 색으로 전개)
+		void SetColors(const PixelColor& fg_color, const PixelColor& bg_color);
+
+		int Rows() const { return rows_; }
+		int Columns() const { return columns_; }
+
+		/* 표시 위치를 lines줄만큼 과거 (양수) / 최신 (음수) 방향으로 이동
+		보관 범위를 넘으면 가장 오래된 줄 / 최신 출력에서 멈춤 */
+		void Scroll(int lines);
+		void ScrollToBottom() { Scroll(-scroll_offset_); }
 
 	private:
+		// 행 안에서 다시 그려야 하는 열 범위 [begin, end)
+		struct DirtySpan {
+			int begin, end;
+		};
+
+		// 전각 글자의 오른쪽 칸 표시 (U+FFFF는 문자로 쓰이지 않음)
+		static constexpr char16_t kWideTail = 0xffff;
+
+		void PutChar(char32_t code);
 		void Newline();
+		// line번째 줄 (처음 출력된 줄 = 0)의 ring 내 위치 (columns_ + 1 칸)
+		char16_t* Line(uint64_t line) {
+			return history_ + (line % history_lines_) * (columns_ + 1);
+		}
+		DirtySpan& Dirty(uint64_t line) { return dirty_[line % kMaxRows]; }
+		void MarkDirty(uint64_t line, int begin, int end);
+		// 현재 표시 중인 화면 최상단 줄 번호
+		uint64_t TopLine() const;
+		uint64_t OldestLine() const;
+		// 화면 row행에 line번째 줄의 [begin, end) 열을 그림
+		void DrawLine(int row, uint64_t line, int begin, int end);
+
 		PixelWriter& writer_;
-		const PixelColor fg_color_, bg_color_;
-		char buffer_[kRows][kColumns + 1];
-		int cursor_row_, cursor_column_;
-};
\ No newline at end of file
+		PixelColor fg_color_, bg_color_;
+		GlyphCache glyphs_; // 512글자 x 1KiB -> console_buf와 함께 bss에 위치
+		Utf8Decoder utf8_; // PutString 사이에 걸쳐 끊긴 UTF-8 글자도 이어서 복원
+		int rows_, columns_;
+		char16_t history_[kHistoryBytes / sizeof(char16_t)];
+		uint64_t history_lines_; // history_에 들어가는 줄 수
+		uint64_t head_line_; // 지금 출력 중인 (가장 최신) 줄 번호
+		int cursor_row_, cursor_column_; // 최신 화면 기준 커서 위치
+		int scroll_offset_; // 0이면 최신 화면, 양수면 그만큼 과거를 표시 중
+		// 줄 번호 % kMaxRows 위치에 그 줄의 바뀐 열 범위 (화면에 보이는 줄끼리는 겹치지 않음)
+		std::array<DirtySpan, kMaxRows> dirty_;
+		uint64_t drawn_top_line_; // window에 마지막으로 그린 시점의 최상단 줄 번호
+		DamageTracker damage_; // window 안에서 다시 합성해야 하는 영역
+		unsigned int layer_id_;
+};
@@ -27,6 +27,9 @@ class Error {
 		kUnknownXHCISpeedID,
 		kNoWaiter,
 		kNoPCIMSI,
+		kUnknownPixelFormat,
+		kNoSerialPort,
+		kCalibrationFailed,
 		kLastOfCode,	// 항상 마지막에 배치
 	};
 
@@ -53,6 +56,9 @@ class Error {
 		"kUnknownXHCISpeedID",
 		"kNoWaiter",
 		"kNoPCIMSI",
+		"kUnknownPixelFormat",
+		"kNoSerialPort",
+		"kCalibrationFailed",
 	};
 	static_assert(Error::Code::kLastOfCode == code_names_.size());
 
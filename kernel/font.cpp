@@ -1,43 +1,224 @@
 #include "font.hpp"
 
-// 가로 8픽셀, 세로 16픽셀
+#include <cstring>
+
+// 가로 8픽셀 (전각 16픽셀), 세로 16픽셀
 
 // #@@range_begin(font_text_bin)
-extern const uint8_t _binary_font_text_bin_start;
-extern const uint8_t _binary_font_text_bin_end;
+extern const uint8_t _binary_font_text_bin_start[];
+extern const uint8_t _binary_font_text_bin_end[];
 extern const uint8_t _binary_font_text_bin_size;
 
-const uint8_t* GetFont(char c) {
-	auto index = 16 * static_cast<unsigned int>(c);
-	if (index >= reinterpret_cast<uintptr_t>(&_binary_font_text_bin_size)) {
-		return nullptr;
+namespace {
+	// font_text.bin의 배치 (tools/makefont.py)
+	const size_t kHeaderBytes = 16, kPageBytes = 2 * 256, kGlyphBytes = 32;
+	const uint16_t kNoEntry = 0xffff;
+
+	// objcopy로 넣은 데이터는 정렬이 보장되지 않으므로 바이트 단위로 읽음
+	uint16_t Read16(const uint8_t* p) {
+		uint16_t value;
+		memcpy(&value, p, sizeof(value));
+		return value;
+	}
+
+	uint32_t Read32(const uint8_t* p) {
+		uint32_t value;
+		memcpy(&value, p, sizeof(value));
+		return value;
+	}
+
+	// 글꼴에 없는 문자: 칸 안쪽의 빈 사각형
+	const uint8_t kMissingHalf[16] = {
+		0x00, 0x7e, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42,
+		0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x7e, 0x00,
+	};
+	const uint8_t kMissingWide[32] = {
+		0x00, 0x00, 0x7f, 0xfe, 0x40, 0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x02,
+		0x40, 0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x02, 0x7f, 0xfe, 0x00, 0x00,
+	};
+
+	// 글꼴에 없는 문자의 폭 판정용: 전각으로 표시하는 범위 (한글, 한자, 가나, 전각 기호)
+	bool IsWide(char32_t code) {
+		return (0x1100 <= code && code <= 0x115f) || (0x2e80 <= code && code <= 0xa4cf) ||
+		       (0xac00 <= code && code <= 0xd7a3) || (0xf900 <= code && code <= 0xfaff) ||
+		       (0xfe30 <= code && code <= 0xfe4f) || (0xff00 <= code && code <= 0xff60) ||
+		       (0xffe0 <= code && code <= 0xffe6);
+	}
+
+	// code의 글자 번호, 없으면 kNoEntry
+	uint16_t GlyphIndex(const uint8_t* font, size_t font_size, char32_t code) {
+		if (code > 0xffff || font_size < kHeaderBytes + kPageBytes || memcmp(font, "KFN1", 4) != 0) {
+			return kNoEntry;
+		}
+		const uint8_t* level1 = font + kHeaderBytes;
+		const uint8_t* level2 = level1 + kPageBytes;
+		const uint16_t page = Read16(level1 + 2 * (code >> 8));
+		if (page == kNoEntry) {
+			return kNoEntry;
+		}
+		return Read16(level2 + kPageBytes * page + 2 * (code & 0xff));
 	}
-	return &_binary_font_text_bin_start + index;
 }
-// #@@range_end(font_text_bin)
 
-// #@@range_begin(write_ascii)
-void WriteAscii(PixelWriter& writer, int x, int y, char c, const PixelColor& color) {
-	const uint8_t* font = GetFont(c);
-	if (font == nullptr) {
-		return;
+Glyph FindGlyph(char32_t code) {
+	const uint8_t* font = _binary_font_text_bin_start;
+	const size_t font_size = reinterpret_cast<uintptr_t>(&_binary_font_text_bin_size);
+	const uint16_t index = GlyphIndex(font, font_size, code);
+	if (index == kNoEntry) {
+		return IsWide(code) ? Glyph{kMissingWide, 16} : Glyph{kMissingHalf, 8};
 	}
-	for (int dy = 0; dy < 16; ++dy) {
-		for (int dx = 0; dx < 8; ++dx) {
-			if ((font[dy] << dx) & 0x80u) {
-			// dy[]를 dx에 맞게 Left Shift하여 맨 왼쪽값이 1이면 출력
-			// 0x80u = 0b10000000
-				writer.Write(x + dx, y + dy, color);
+	const size_t page_count = Read16(font + 4), glyph_count = Read32(font + 8);
+	const uint8_t* widths = font + kHeaderBytes + kPageBytes * (1 + page_count);
+	const uint8_t* bitmaps = widths + glyph_count;
+	return {bitmaps + kGlyphBytes * index, widths[index]};
+}
+// #@@range_end(font_text_bin)
+
+// #@@range_begin(utf8_decoder)
+int Utf8Decoder::Feed(uint8_t byte, char32_t out[2]) {
+	int n = 0;
+	if (remaining_ > 0) {
+		if ((byte & 0xc0u) == 0x80u) {
+			code_ = (code_ << 6) | (byte & 0x3fu);
+			if (--remaining_ == 0) {
+				const bool valid = code_ >= min_ && code_ <= 0x10ffff &&
+				                   !(0xd800 <= code_ && code_ <= 0xdfff);
+				out[n++] = valid ? code_ : kReplacement;
 			}
+			return n;
 		}
+		// continuation 바이트가 모자람 -> 끊긴 글자는 U+FFFD, 이 바이트는 새 글자로 처리
+		remaining_ = 0;
+		out[n++] = kReplacement;
 	}
+
+	if (byte < 0x80u) {
+		out[n++] = byte;
+	} else if ((byte & 0xe0u) == 0xc0u) {
+		code_ = byte & 0x1fu, min_ = 0x80, remaining_ = 1;
+	} else if ((byte & 0xf0u) == 0xe0u) {
+		code_ = byte & 0x0fu, min_ = 0x800, remaining_ = 2;
+	} else if ((byte & 0xf8u) == 0xf0u) {
+		code_ = byte & 0x07u, min_ = 0x10000, remaining_ = 3;
+	} else {
+		out[n++] = kReplacement; // 단독 continuation 바이트, 0xf8 이상
+	}
+	return n;
+}
+// #@@range_end(utf8_decoder)
+
+// #@@range_begin(write_ascii)
+void WriteAscii(PixelWriter& writer, int x, int y, char c, const PixelColor& color) {
+	const Glyph glyph = FindGlyph(static_cast<uint8_t>(c));
+	// 폰트 1행 = 1바이트, MSB가 왼쪽 픽셀 -> 비트맵 그대로 writer에 전달
+	writer.WriteMonochrome({x, y}, glyph.bitmap, glyph.width, 16, color);
+	++render_counters.glyphs_drawn;
 }
 // #@@range_end(write_ascii)
 
 // #@@range_begin(write_string)
 void WriteString(PixelWriter& writer, int x, int y, const char* s, const PixelColor& color) {
-	for (int i = 0; s[i] != '\0'; ++i) {
-		WriteAscii(writer, x + 8 * i, y, s[i], color);
+	Utf8Decoder decoder;
+	for (; *s != '\0'; ++s) {
+		char32_t codes[2];
+		const int n = decoder.Feed(static_cast<uint8_t>(*s), codes);
+		for (int i = 0; i < n; ++i) {
+			const Glyph glyph = FindGlyph(codes[i]);
+			writer.WriteMonochrome({x, y}, glyph.bitmap, glyph.width, 16, color);
+			x += glyph.width;
+			++render_counters.glyphs_drawn;
+		}
+	}
+}
+// #@@range_end(write_string)
+
+// #@@range_begin(glyph_cache)
+GlyphCache::GlyphCache() : lru_head_{0}, lru_tail_{kSlots - 1} {
+	// 처음에는 모든 slot이 빈 상태로 LRU 목록에만 연결 (어느 bucket에도 없음)
+	for (int i = 0; i < kBuckets; ++i) {
+		bucket_[i] = kNone;
+	}
+	for (int i = 0; i < kSlots; ++i) {
+		slots_[i] = {0, 0, 0, 0, kNone, i - 1, i + 1 < kSlots ? i + 1 : kNone};
+	}
+}
+
+void GlyphCache::SetColors(PixelFormat format, const PixelColor& fg, const PixelColor& bg) {
+	fg_ = EncodePixel(format, fg);
+	bg_ = EncodePixel(format, bg);
+}
+
+int GlyphCache::Bucket(char32_t code, uint32_t fg, uint32_t bg) {
+	const uint32_t h = code * 2654435761u ^ fg * 0x9e3779b1u ^ (bg * 0x85ebca6bu >> 7);
+	return (h ^ (h >> 16)) & (kBuckets - 1);
+}
+
+GlyphCache::Image GlyphCache::Get(char32_t code) {
+	// 1. hash 표에서 찾으면 LRU 목록 맨 앞으로 옮기고 그대로 반환
+	const int bucket = Bucket(code, fg_, bg_);
+	for (int i = bucket_[bucket]; i != kNone; i = slots_[i].hash_next) {
+		const Slot& slot = slots_[i];
+		if (slot.code == code && slot.fg == fg_ && slot.bg == bg_) {
+			if (i != lru_head_) {
+				Unlink(i);
+				PushFront(i);
+			}
+			return {pixels_[i], slot.width};
+		}
+	}
+
+	// 2. 없으면 가장 오래 쓰이지 않은 slot을 비우고 전개
+	const int i = lru_tail_;
+	RemoveFromBucket(i);
+	Unlink(i);
+	Expand(i, code);
+	slots_[i].hash_next = bucket_[bucket];
+	bucket_[bucket] = i;
+	PushFront(i);
+	return {pixels_[i], slots_[i].width};
+}
+
+void GlyphCache::Unlink(int slot) {
+	Slot& s = slots_[slot];
+	(s.lru_prev == kNone ? lru_head_ : slots_[s.lru_prev].lru_next) = s.lru_next;
+	(s.lru_next == kNone ? lru_tail_ : slots_[s.lru_next].lru_prev) = s.lru_prev;
+}
+
+void GlyphCache::PushFront(int slot) {
+	Slot& s = slots_[slot];
+	s.lru_prev = kNone;
+	s.lru_next = lru_head_;
+	(lru_head_ == kNone ? lru_tail_ : slots_[lru_head_].lru_prev) = slot;
+	lru_head_ = slot;
+}
+
+void GlyphCache::RemoveFromBucket(int slot) {
+	const Slot& s = slots_[slot];
+	if (s.width == 0) { // 아직 쓰인 적 없는 slot
+		return;
+	}
+	for (int* p = &bucket_[Bucket(s.code, s.fg, s.bg)]; *p != kNone; p = &slots_[*p].hash_next) {
+		if (*p == slot) {
+			*p = s.hash_next;
+			return;
+		}
+	}
+}
+
+void GlyphCache::Expand(int slot, char32_t code) {
+	const Glyph glyph = FindGlyph(code);
+	const int bytes_per_row = (glyph.width + 7) / 8;
+	uint32_t* dst = pixels_[slot];
+	for (int dy = 0; dy < kHeight; ++dy) {
+		const uint8_t* row = glyph.bitmap + bytes_per_row * dy;
+		for (int dx = 0; dx < glyph.width; ++dx) {
+			*dst++ = ((row[dx / 8] << (dx % 8)) & 0x80u) ? fg_ : bg_;
+		}
 	}
+	slots_[slot].code = code;
+	slots_[slot].fg = fg_;
+	slots_[slot].bg = bg_;
+	slots_[slot].width = glyph.width;
+	++render_counters.glyphs_rasterized;
 }
-// #@@range_end(write_string)
\ No newline at end of file
+// #@@range_end(glyph_cache)
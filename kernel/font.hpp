@@ -3,5 +3,83 @@
 #include <cstdint>
 #include "graphics.hpp"
 
+// #@@range_begin(glyph)
+/* 글꼴 파일 (tools/makefont.py, font_text.bin)의 글자 1개
+높이 16픽셀, 폭 8 (반각) 또는 16 (전각), 행마다 (width + 7) / 8 바이트 (MSB가 왼쪽 픽셀) */
+struct Glyph {
+	const uint8_t* bitmap;
+	int width;
+};
+
+/* code point (BMP)의 글자를 2단계 페이지 색인 (상위 8bit -> 페이지, 하위 8bit -> 글자)으로 찾음
+글꼴에 없는 문자는 폭에 맞는 빈 사각형 (한글, 한자 등은 전각) */
+Glyph FindGlyph(char32_t code);
+// #@@range_end(glyph)
+
+// #@@range_begin(utf8_decoder)
+/* UTF-8 바이트열을 1바이트씩 받아 code point로 복원 (여러 번의 출력에 걸쳐 끊긴 글자도 이어서 처리)
+잘못된 바이트열 (끊긴 sequence, overlong, surrogate 등)은 U+FFFD */
+class Utf8Decoder {
+ public:
+	static const char32_t kReplacement = 0xfffd;
+
+	// 완성된 code point를 out에 넣고 그 개수 (0 - 2)를 반환
+	int Feed(uint8_t byte, char32_t out[2]);
+
+ private:
+	char32_t code_ = 0, min_ = 0;
+	int remaining_ = 0; // 남은 continuation 바이트 수
+};
+// #@@range_end(utf8_decoder)
+
 void WriteAscii(PixelWriter& writer, int x, int y, char c, const PixelColor& color);
-void WriteString(PixelWriter& writer, int x, int y, const char* s, const PixelColor& color);
\ No newline at end of file
+// s는 UTF-8, 전각 글자는 16픽셀씩 전진
+void WriteString(PixelWriter& writer, int x, int y, const char* s, const PixelColor& color);
+
+// #@@range_begin(glyph_cache)
+/* 글자를 전경색/배경색의 32bit 픽셀로 전개해 두는 캐시 (code point + 색을 key로 하는 LRU)
+글자 1개 = 행 복사 16회 (비트 검사, 픽셀 단위 Write X)
+색을 바꿔도 다른 색의 전개 결과는 남아 있어, 원래 색으로 돌아오면 다시 전개하지 않음
+가득 차면 가장 오래 쓰이지 않은 글자 자리를 재사용 */
+class GlyphCache {
+ public:
+	static const int kWidth = 8, kHeight = 16; // 반각 1칸, 전각은 2칸
+	static const int kMaxWidth = 16;
+	static const int kSlots = 512;
+
+	// 전개된 글자: width x kHeight 픽셀 (행 간격 = width, 배경 포함), SetColors로 지정한 포맷
+	struct Image {
+		const uint32_t* pixels;
+		int width;
+	};
+
+	GlyphCache();
+	// 이후 Get에서 쓸 색
+	void SetColors(PixelFormat format, const PixelColor& fg, const PixelColor& bg);
+	Image Get(char32_t code);
+
+ private:
+	static const int kBuckets = 1024; // hash 표 크기 (2의 거듭제곱)
+	static const int kNone = -1;
+
+	struct Slot {
+		char32_t code;
+		uint32_t fg, bg;
+		int width;
+		int hash_next; // 같은 bucket의 다음 slot
+		int lru_prev, lru_next; // 최근에 쓰인 순서 (lru_head_가 가장 최근)
+	};
+
+	static int Bucket(char32_t code, uint32_t fg, uint32_t bg);
+	void Unlink(int slot);
+	void PushFront(int slot);
+	void RemoveFromBucket(int slot);
+	void Expand(int slot, char32_t code);
+
+	uint32_t fg_ = 0, bg_ = 0;
+	int bucket_[kBuckets];
+	Slot slots_[kSlots];
+	int lru_head_, lru_tail_;
+	uint32_t pixels_[kSlots][kHeight * kMaxWidth];
+};
+// #@@range_end(glyph_cache)
@@ -0,0 +1,300 @@
+#include "format.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+namespace {
+	struct Spec {
+		bool left = false, plus = false, space = false, alt = false, zero = false;
+		int width = 0;
+		int precision = -1; // -1 = 지정 없음
+	};
+
+	// sink 호출과 출력 바이트 수 세기
+	class Output {
+	 public:
+		Output(FormatSink sink, void* context) : sink_{sink}, context_{context} {}
+
+		void Write(const char* s, size_t len) {
+			if (len > 0) {
+				sink_(context_, s, len);
+				count_ += len;
+			}
+		}
+
+		// c (' ' 또는 '0')를 n개
+		void Pad(char c, int n) {
+			static const char kSpaces[] = "                ";
+			static const char kZeros[] = "0000000000000000";
+			const char* src = c == '0' ? kZeros : kSpaces;
+			for (; n > 0; n -= sizeof(kSpaces) - 1) {
+				Write(src, n < static_cast<int>(sizeof(kSpaces) - 1) ? n : sizeof(kSpaces) - 1);
+			}
+		}
+
+		int Count() const { return static_cast<int>(count_); }
+
+	 private:
+		FormatSink sink_;
+		void* context_;
+		size_t count_ = 0;
+	};
+
+	// 폭 기준 좌우 공백 padding
+	void WritePadded(Output& out, const Spec& spec, const char* s, size_t len) {
+		const int pad = spec.width - static_cast<int>(len);
+		if (!spec.left) {
+			out.Pad(' ', pad);
+		}
+		out.Write(s, len);
+		if (spec.left) {
+			out.Pad(' ', pad);
+		}
+	}
+
+	// #@@range_begin(format_integer)
+	/* [공백] [부호 / 0x] [정밀도·0 플래그의 0] 숫자 [공백]
+	숫자는 buf 끝에서부터 채움 (64bit 8진수도 22자리) */
+	void WriteInteger(Output& out, const Spec& spec, uint64_t value, bool negative,
+	                  unsigned base, bool upper) {
+		const char* digit_chars = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+		char buf[24];
+		char* const end = buf + sizeof(buf);
+		char* digits = end;
+		for (uint64_t v = value; v != 0; v /= base) {
+			*--digits = digit_chars[v % base];
+		}
+		if (value == 0 && spec.precision != 0) {
+			*--digits = '0';
+		}
+		int num_digits = static_cast<int>(end - digits);
+
+		char prefix[2];
+		int prefix_len = 0;
+		if (negative) {
+			prefix[prefix_len++] = '-';
+		} else if (spec.plus) {
+			prefix[prefix_len++] = '+';
+		} else if (spec.space) {
+			prefix[prefix_len++] = ' ';
+		}
+		if (spec.alt && base == 16 && value != 0) {
+			prefix[prefix_len++] = '0';
+			prefix[prefix_len++] = upper ? 'X' : 'x';
+		}
+
+		int zeros = spec.precision > num_digits ? spec.precision - num_digits : 0;
+		if (spec.alt && base == 8 && zeros == 0 && (num_digits == 0 || *digits != '0')) {
+			zeros = 1; // 8진수 #: 맨 앞이 0이 되도록
+		}
+		int pad = spec.width - prefix_len - zeros - num_digits;
+		if (spec.zero && !spec.left && spec.precision < 0 && pad > 0) {
+			zeros += pad;
+			pad = 0;
+		}
+
+		if (!spec.left) {
+			out.Pad(' ', pad);
+		}
+		out.Write(prefix, prefix_len);
+		out.Pad('0', zeros);
+		out.Write(digits, num_digits);
+		if (spec.left) {
+			out.Pad(' ', pad);
+		}
+	}
+	// #@@range_end(format_integer)
+
+	enum class Length { kChar, kShort, kInt, kLong };
+
+	int64_t SignedArg(Length length, va_list& ap) {
+		switch (length) {
+		case Length::kChar: return static_cast<signed char>(va_arg(ap, int));
+		case Length::kShort: return static_cast<short>(va_arg(ap, int));
+		case Length::kInt: return va_arg(ap, int);
+		default: return va_arg(ap, int64_t);
+		}
+	}
+
+	uint64_t UnsignedArg(Length length, va_list& ap) {
+		switch (length) {
+		case Length::kChar: return static_cast<unsigned char>(va_arg(ap, unsigned int));
+		case Length::kShort: return static_cast<unsigned short>(va_arg(ap, unsigned int));
+		case Length::kInt: return va_arg(ap, unsigned int);
+		default: return va_arg(ap, uint64_t);
+		}
+	}
+
+	int ParseNumber(const char*& p) {
+		int n = 0;
+		while ('0' <= *p && *p <= '9') {
+			n = n * 10 + (*p++ - '0');
+		}
+		return n;
+	}
+
+	struct BufferContext {
+		char* buf;
+		size_t size; // '\0' 자리 제외
+		size_t pos;
+	};
+
+	void BufferSink(void* context, const char* s, size_t len) {
+		auto c = static_cast<BufferContext*>(context);
+		const size_t n = len < c->size - c->pos ? len : c->size - c->pos;
+		memcpy(c->buf + c->pos, s, n);
+		c->pos += n;
+	}
+
+	void NullSink(void*, const char*, size_t) {}
+}
+
+// #@@range_begin(vformat)
+int VFormat(FormatSink sink, void* context, const char* format, va_list ap) {
+	Output out{sink, context};
+	va_list args;
+	va_copy(args, ap); // 참조로 넘기기 위해 (va_list가 배열형인 ABI)
+
+	const char* p = format;
+	while (*p) {
+		// 1. 다음 %까지는 그대로 한 번에
+		const char* literal = p;
+		while (*p && *p != '%') {
+			++p;
+		}
+		out.Write(literal, p - literal);
+		if (*p == '\0') {
+			break;
+		}
+		const char* conversion_start = p++;
+
+		// 2. 플래그, 폭, 정밀도, 길이
+		Spec spec;
+		for (;; ++p) {
+			if (*p == '-') spec.left = true;
+			else if (*p == '+') spec.plus = true;
+			else if (*p == ' ') spec.space = true;
+			else if (*p == '#') spec.alt = true;
+			else if (*p == '0') spec.zero = true;
+			else break;
+		}
+		if (*p == '*') {
+			++p;
+			spec.width = va_arg(args, int);
+			if (spec.width < 0) {
+				spec.left = true;
+				spec.width = -spec.width;
+			}
+		} else {
+			spec.width = ParseNumber(p);
+		}
+		if (*p == '.') {
+			++p;
+			if (*p == '*') {
+				++p;
+				spec.precision = va_arg(args, int); // 음수 = 지정 없음
+			} else {
+				spec.precision = ParseNumber(p);
+			}
+		}
+		Length length = Length::kInt;
+		if (*p == 'h') {
+			++p;
+			length = Length::kShort;
+			if (*p == 'h') {
+				++p;
+				length = Length::kChar;
+			}
+		} else if (*p == 'l' || *p == 'z' || *p == 'j' || *p == 't') { // 모두 64bit
+			length = Length::kLong;
+			if (*p++ == 'l' && *p == 'l') {
+				++p;
+			}
+		}
+
+		// 3. 변환 (+, 공백은 부호 있는 변환에만)
+		if (*p != 'd' && *p != 'i') {
+			spec.plus = spec.space = false;
+		}
+		switch (*p) {
+		case 'd':
+		case 'i': {
+			const int64_t value = SignedArg(length, args);
+			const uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : value;
+			WriteInteger(out, spec, magnitude, value < 0, 10, false);
+			break;
+		}
+		case 'u':
+			WriteInteger(out, spec, UnsignedArg(length, args), false, 10, false);
+			break;
+		case 'o':
+			WriteInteger(out, spec, UnsignedArg(length, args), false, 8, false);
+			break;
+		case 'x':
+		case 'X':
+			WriteInteger(out, spec, UnsignedArg(length, args), false, 16, *p == 'X');
+			break;
+		case 'p':
+			spec.alt = true;
+			WriteInteger(out, spec, reinterpret_cast<uintptr_t>(va_arg(args, void*)), false, 16, false);
+			break;
+		case 'c': {
+			const char c = static_cast<char>(va_arg(args, int));
+			WritePadded(out, spec, &c, 1);
+			break;
+		}
+		case 's': {
+			const char* s = va_arg(args, const char*);
+			if (!s) {
+				s = "(null)";
+			}
+			const size_t len = spec.precision < 0 ? strlen(s) : strnlen(s, spec.precision);
+			WritePadded(out, spec, s, len);
+			break;
+		}
+		case '%':
+			out.Write("%", 1);
+			break;
+		default: // 알 수 없는 변환은 그대로 출력 (format 속성의 경고 대상)
+			if (*p == '\0') {
+				--p;
+			}
+			out.Write(conversion_start, p + 1 - conversion_start);
+			break;
+		}
+		++p;
+	}
+
+	va_end(args);
+	return out.Count();
+}
+// #@@range_end(vformat)
+
+int Format(FormatSink sink, void* context, const char* format, ...) {
+	va_list ap;
+	va_start(ap, format);
+	const int result = VFormat(sink, context, format, ap);
+	va_end(ap);
+	return result;
+}
+
+int VFormatToBuffer(char* buf, size_t size, const char* format, va_list ap) {
+	BufferContext context{buf, size > 0 ? size - 1 : 0, 0};
+	const int result = VFormat(BufferSink, &context, format, ap);
+	if (size > 0) {
+		buf[context.pos] = '\0';
+	}
+	return result;
+}
+
+int FormatToBuffer(char* buf, size_t size, const char* format, ...) {
+	va_list ap;
+	va_start(ap, format);
+	const int result = VFormatToBuffer(buf, size, format, ap);
+	va_end(ap);
+	return result;
+}
+
+int VFormatLength(const char* format, va_list ap) {
+	return VFormat(NullSink, nullptr, format, ap);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdarg>
+#include <cstddef>
+
+// #@@range_begin(format_sink)
+/* 포맷 결과를 받는 곳: 조각 (format의 문자열 부분, 숫자, padding)마다 호출
+-> 중간 버퍼 없이 출력 대상 (log ring의 예약한 자리 등)에 바로 기록
+context는 Format에 넘긴 값 그대로 */
+using FormatSink = void (*)(void* context, const char* s, size_t len);
+// #@@range_end(format_sink)
+
+// #@@range_begin(format)
+/* newlib vsprintf 대신 쓰는 커널 내장 printf (heap, locale, 부동소수점 X)
+플래그 - 0 + 공백 #, 폭과 정밀도 (숫자, *), 길이 hh h l ll z j t, 변환 d i u o x X c s p %
+format 속성 -> 인자 형식이 맞지 않으면 컴파일 시 경고 (-Wformat)
+반환값은 출력한 바이트 수 */
+int VFormat(FormatSink sink, void* context, const char* format, va_list ap);
+int Format(FormatSink sink, void* context, const char* format, ...)
+	__attribute__((format(printf, 3, 4)));
+
+// snprintf와 같음: 최대 size - 1바이트 + '\0', 반환값은 자르기 전의 길이
+int VFormatToBuffer(char* buf, size_t size, const char* format, va_list ap);
+int FormatToBuffer(char* buf, size_t size, const char* format, ...)
+	__attribute__((format(printf, 3, 4)));
+
+// 출력하지 않고 길이만 계산 (자리를 먼저 예약해야 하는 출력 대상용)
+int VFormatLength(const char* format, va_list ap);
+// #@@range_end(format)
@@ -0,0 +1,129 @@
+#include "frame_buffer.hpp"
+
+namespace {
+	uintptr_t graphics_memory_ptr = 0;
+	uintptr_t graphics_memory_end = 0;
+
+	int Area(const Rectangle<int>& rect) {
+		return rect.size.x * rect.size.y;
+	}
+
+	/* 겹치는 사각형, 또는 합쳐도 여분의 픽셀이 생기지 않는 (변을 공유하는) 사각형은 합침
+	대각선으로만 닿은 것까지 합치면 union이 두 배 가까이 커지므로 제외 */
+	bool ShouldMerge(const Rectangle<int>& a, const Rectangle<int>& b) {
+		const int overlap = Area(a & b);
+		return overlap > 0 || Area(a | b) == Area(a) + Area(b);
+	}
+}
+
+// #@@range_begin(graphics_memory)
+void InitializeGraphicsMemory(uint8_t* base, size_t size) {
+	graphics_memory_ptr = reinterpret_cast<uintptr_t>(base);
+	graphics_memory_end = graphics_memory_ptr + size;
+}
+
+uint8_t* AllocGraphicsMemory(size_t size) {
+	const uintptr_t p = (graphics_memory_ptr + 63) & ~static_cast<uintptr_t>(63); // 캐시 라인 정렬
+	if (graphics_memory_ptr == 0 || graphics_memory_end < p + size) {
+		return nullptr;
+	}
+	graphics_memory_ptr = p + size;
+	return reinterpret_cast<uint8_t*>(p);
+}
+// #@@range_end(graphics_memory)
+
+// #@@range_begin(damage_tracker)
+void DamageTracker::SetBounds(const Rectangle<int>& bounds) {
+	bounds_ = bounds;
+	Clear();
+}
+
+void DamageTracker::Add(const Rectangle<int>& area) {
+	Rectangle<int> rect = area & bounds_;
+	if (IsEmpty(rect)) {
+		return;
+	}
+
+	// 이미 기록된 영역에 포함되면 끝 (커서, 글자 단위의 작은 갱신은 대부분 여기서 종료)
+	for (int i = 0; i < num_rects_; ++i) {
+		if (Area(rects_[i] & rect) == Area(rect)) {
+			return;
+		}
+	}
+
+	// 겹치는 사각형을 모두 흡수 -> 합친 결과가 다른 사각형과 새로 겹칠 수 있으므로 처음부터 다시
+	for (int i = 0; i < num_rects_;) {
+		if (ShouldMerge(rects_[i], rect)) {
+			rect = rect | rects_[i];
+			rects_[i] = rects_[--num_rects_];
+			i = 0;
+		} else {
+			++i;
+		}
+	}
+
+	if (num_rects_ == kMaxRects) {
+		// 빈자리가 없으면 합쳤을 때 면적 증가가 가장 작은 사각형과 합침
+		int best = 0, best_growth = Area(rects_[0] | rect) - Area(rects_[0]);
+		for (int i = 1; i < num_rects_; ++i) {
+			const int growth = Area(rects_[i] | rect) - Area(rects_[i]);
+			if (growth < best_growth) {
+				best = i;
+				best_growth = growth;
+			}
+		}
+		rect = rect | rects_[best];
+		rects_[best] = rects_[--num_rects_];
+	}
+	rects_[num_rects_++] = rect;
+}
+
+void DamageTracker::Clear() {
+	num_rects_ = 0;
+}
+// #@@range_end(damage_tracker)
+
+// #@@range_begin(frame_buffer_init)
+Error FrameBuffer::Initialize(const FrameBufferConfig& vram_config) {
+	vram_config_ = vram_config;
+	config_ = vram_config;
+
+	const size_t bytes = 4 * static_cast<size_t>(vram_config.pixels_per_scan_line) *
+		vram_config.vertical_resolution;
+	uint8_t* shadow = AllocGraphicsMemory(bytes);
+	if (shadow == nullptr) {
+		return MAKE_ERROR(Error::kNoEnoughMemory);
+	}
+	config_.frame_buffer = shadow;
+
+	// RAM 대상 writer (일반 store), VRAM에는 Flush만 non-temporal store로 씀
+	writer_ = NewPixelWriter(writer_storage_, config_, false);
+	if (writer_ == nullptr) {
+		return MAKE_ERROR(Error::kUnknownPixelFormat);
+	}
+
+	damage_.SetBounds({{0, 0}, {static_cast<int>(config_.horizontal_resolution),
+	                            static_cast<int>(config_.vertical_resolution)}});
+	writer_->SetDamageTracker(&damage_);
+	return MAKE_ERROR(Error::kSuccess);
+}
+// #@@range_end(frame_buffer_init)
+
+// #@@range_begin(frame_buffer_flush)
+void FrameBuffer::Flush() {
+	const uint32_t stride = config_.pixels_per_scan_line;
+	const auto shadow = reinterpret_cast<const uint32_t*>(config_.frame_buffer);
+	const auto vram = reinterpret_cast<uint32_t*>(vram_config_.frame_buffer);
+	for (int i = 0; i < damage_.Count(); ++i) {
+		const Rectangle<int>& rect = damage_[i];
+		size_t offset = stride * rect.pos.y + rect.pos.x;
+		render_counters.flush_bytes += 4ul * rect.size.x * rect.size.y;
+		for (int dy = 0; dy < rect.size.y; ++dy) {
+			StreamCopySpan32(vram + offset, shadow + offset, rect.size.x);
+			offset += stride;
+		}
+	}
+	StreamFence();
+	damage_.Clear();
+}
+// #@@range_end(frame_buffer_flush)
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "error.hpp"
+#include "frame_buffer_config.hpp"
+#include "graphics.hpp"
+
+/* GOP 프레임 버퍼 (VRAM)는 write-combining 영역 -> 픽셀 단위 쓰기, 읽기가 매우 느림
+그리기는 모두 RAM 상의 shadow buffer에 하고, 변경된 영역 (damage)만 모아서
+Flush 시점에 VRAM으로 한 번에 복사 (VRAM에서 읽기 X) */
+
+// #@@range_begin(graphics_memory)
+/* loader가 확보해 넘겨준 RAM 영역에서 화면 크기 버퍼를 잘라 쓰는 단순한 할당자
+(usb::AllocMem과 같은 방식, 해제 X) */
+void InitializeGraphicsMemory(uint8_t* base, size_t size);
+uint8_t* AllocGraphicsMemory(size_t size);
+// #@@range_end(graphics_memory)
+
+// #@@range_begin(damage_tracker)
+/* 화면에서 갱신된 영역 목록
+겹치거나 맞닿은 사각형은 추가 시점에 합쳐서 Flush에서 같은 픽셀을 두 번 복사하지 않게 함 */
+class DamageTracker {
+ public:
+	static const int kMaxRects = 16;
+
+	void SetBounds(const Rectangle<int>& bounds);
+	void Add(const Rectangle<int>& area);
+	void Clear();
+
+	int Count() const { return num_rects_; }
+	const Rectangle<int>& operator [](int i) const { return rects_[i]; }
+
+ private:
+	Rectangle<int> bounds_{{0, 0}, {0, 0}};
+	std::array<Rectangle<int>, kMaxRects> rects_;
+	int num_rects_ = 0;
+};
+// #@@range_end(damage_tracker)
+
+// #@@range_begin(frame_buffer)
+class FrameBuffer {
+ public:
+	/* vram_config와 같은 해상도, 포맷의 shadow buffer를 graphics memory에서 확보
+	확보할 수 없으면 kNoEnoughMemory, 지원하지 않는 pixel format이면 kUnknownPixelFormat (둘 다 Writer 사용 불가) */
+	Error Initialize(const FrameBufferConfig& vram_config);
+
+	PixelWriter& Writer() { return *writer_; }
+	const FrameBufferConfig& Config() const { return config_; }
+
+	// writer를 거치지 않고 shadow buffer를 직접 수정한 경우 호출
+	void MarkDirty(const Rectangle<int>& area) { damage_.Add(area); }
+	// 누적된 damage 영역만 non-temporal store로 VRAM에 복사
+	void Flush();
+
+ private:
+	FrameBufferConfig vram_config_{}, config_{};
+	PixelWriterStorage writer_storage_;
+	PixelWriter* writer_ = nullptr;
+	DamageTracker damage_;
+};
+// #@@range_end(frame_buffer)
@@ -15,4 +15,7 @@ struct FrameBufferConfig {
 	uint32_t horizontal_resolution; // 수평 해상도
 	uint32_t vertical_resolution; // 수직 해상도
 	enum PixelFormat pixel_format; // 4가지
+	// loader가 확보한 RAM 영역 (shadow buffer 등 화면 크기 버퍼용, 확보 실패 시 loader가 정지)
+	uint8_t* graphics_memory;
+	uint64_t graphics_memory_size;
 };
\ No newline at end of file
@@ -1,40 +1,241 @@
 // #@@range_begin(pixel_writer_impl)
 #include "graphics.hpp"
 
-void RGBResv8BitPerColorPixelWriter::Write(int x, int y, const PixelColor& c) {
-	auto p = PixelAt(x, y);
-	p[0] = c.r;
-	p[1] = c.g;
-	p[2] = c.b;
+#include <cstring>
+#include <new>
+#include <emmintrin.h>
+#include "frame_buffer.hpp"
+
+// #@@range_begin(span_impl)
+void FillSpan32(uint32_t* dst, uint32_t value, size_t count) {
+	// rep stosd: ecx개의 eax를 [rdi]부터 연속 저장 (fast string 동작으로 캐시 라인 단위 처리)
+	__asm__ volatile("rep stosl"
+			: "+D"(dst), "+c"(count) : "a"(value) : "memory");
+}
+
+void CopySpan32(uint32_t* dst, const uint32_t* src, size_t count) {
+	size_t qwords = count / 2; // 8바이트 단위로 옮기고 홀수 픽셀 1개는 따로
+	__asm__ volatile("rep movsq"
+			: "+D"(dst), "+S"(src), "+c"(qwords) : : "memory");
+	if (count & 1) {
+		*dst = *src;
+	}
+}
+
+void StreamFillSpan32(uint32_t* dst, uint32_t value, size_t count) {
+	// 16바이트 경계까지는 movnti (4바이트), 이후 movntdq (16바이트), 나머지는 다시 movnti
+	while (count > 0 && (reinterpret_cast<uintptr_t>(dst) & 0xf)) {
+		_mm_stream_si32(reinterpret_cast<int*>(dst++), value);
+		--count;
+	}
+	const __m128i v = _mm_set1_epi32(value);
+	for (; count >= 4; count -= 4, dst += 4) {
+		_mm_stream_si128(reinterpret_cast<__m128i*>(dst), v);
+	}
+	while (count-- > 0) {
+		_mm_stream_si32(reinterpret_cast<int*>(dst++), value);
+	}
+}
+
+void StreamCopySpan32(uint32_t* dst, const uint32_t* src, size_t count) {
+	while (count > 0 && (reinterpret_cast<uintptr_t>(dst) & 0xf)) {
+		_mm_stream_si32(reinterpret_cast<int*>(dst++), *src++);
+		--count;
+	}
+	for (; count >= 4; count -= 4, dst += 4, src += 4) { // src는 정렬 보장 X -> loadu
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+		_mm_stream_si128(reinterpret_cast<__m128i*>(dst), v);
+	}
+	while (count-- > 0) {
+		_mm_stream_si32(reinterpret_cast<int*>(dst++), *src++);
+	}
+}
+
+void StreamFence() {
+	_mm_sfence();
+}
+// #@@range_end(span_impl)
+
+RenderCounters render_counters;
+
+void PixelWriter::MarkDamaged(const Vector2D<int>& pos, const Vector2D<int>& size) {
+	// 모든 primitive가 clip 후 1회 호출 -> 여기서 세면 도형당 덧셈 1회 (DrawRectangle는 외곽 사각형 전체)
+	render_counters.pixels_written += static_cast<uint64_t>(size.x) * size.y;
+	if (damage_) {
+		damage_->Add({pos, size});
+	}
+}
+
+template <PixelFormat Format>
+void FrameBufferPixelWriter<Format>::FillClipped(const Rectangle<int>& rect, uint32_t value) {
+	if (IsEmpty(rect)) {
+		return;
+	}
+	const uint32_t stride = PixelsPerScanLine();
+	uint32_t* row = reinterpret_cast<uint32_t*>(PixelAt(rect.pos.x, rect.pos.y));
+	if (IsVideoMemory()) {
+		for (int dy = 0; dy < rect.size.y; ++dy) { // 행 선두 주소만 stride씩 이동, 곱셈 X
+			StreamFillSpan32(row, value, rect.size.x);
+			row += stride;
+		}
+		StreamFence();
+	} else {
+		for (int dy = 0; dy < rect.size.y; ++dy) {
+			FillSpan32(row, value, rect.size.x);
+			row += stride;
+		}
+	}
+}
+
+template <PixelFormat Format>
+void FrameBufferPixelWriter<Format>::FillRectangle(const Vector2D<int>& pos,
+		const Vector2D<int>& size, const PixelColor& c) {
+	const Rectangle<int> rect = Clip(pos, size);
+	if (IsEmpty(rect)) {
+		return;
+	}
+	MarkDamaged(rect.pos, rect.size);
+	FillClipped(rect, Encode(c));
 }
 // #@@range_end(pixel_writer_impl)
 
-void BGRResv8BitPerColorPixelWriter::Write(int x, int y, const PixelColor& c) {
-	auto p = PixelAt(x, y);
-	p[0] = c.b;
-	p[1] = c.g;
-	p[2] = c.r;
+template <PixelFormat Format>
+void FrameBufferPixelWriter<Format>::DrawRectangle(const Vector2D<int>& pos,
+		const Vector2D<int>& size, const PixelColor& c) {
+	const Rectangle<int> rect = Clip(pos, size);
+	if (IsEmpty(rect) || size.x <= 0 || size.y <= 0) {
+		return;
+	}
+	MarkDamaged(rect.pos, rect.size);
+	// 네 변을 각각 폭 1의 사각형으로 잘라서 채움 (clip 밖으로 나간 변은 빈 사각형이 됨)
+	const uint32_t value = Encode(c);
+	FillClipped(Clip(pos, {size.x, 1}), value);
+	FillClipped(Clip({pos.x, pos.y + size.y - 1}, {size.x, 1}), value);
+	FillClipped(Clip({pos.x, pos.y + 1}, {1, size.y - 2}), value);
+	FillClipped(Clip({pos.x + size.x - 1, pos.y + 1}, {1, size.y - 2}), value);
 }
 
-// #@@range_begin(draw_rectangle)
-void DrawRectangle(PixelWriter& writer, const Vector2D<int>& pos, const Vector2D<int>& size, const PixelColor& c) {
-	for (int dx = 0; dx < size.x; ++dx) {
-		writer.Write(pos.x + dx, pos.y, c);
-		writer.Write(pos.x + dx, pos.y + size.y - 1, c);
+template <PixelFormat Format>
+void FrameBufferPixelWriter<Format>::WriteMonochrome(const Vector2D<int>& pos,
+		const uint8_t* bitmap, int width, int height, const PixelColor& c) {
+	const Rectangle<int> rect = Clip(pos, {width, height});
+	if (IsEmpty(rect)) {
+		return;
+	}
+	MarkDamaged(rect.pos, rect.size);
+	const uint32_t value = Encode(c);
+	const uint32_t stride = PixelsPerScanLine();
+	const int bytes_per_row = (width + 7) / 8;
+	// 잘린 만큼 비트맵의 시작 행, 열을 건너뜀
+	const int first_x = rect.pos.x - pos.x, last_x = first_x + rect.size.x;
+	bitmap += bytes_per_row * (rect.pos.y - pos.y);
+	uint32_t* row = reinterpret_cast<uint32_t*>(PixelAt(rect.pos.x, rect.pos.y)) - first_x;
+	for (int dy = 0; dy < rect.size.y; ++dy) {
+		for (int dx = first_x; dx < last_x; ++dx) {
+			if ((bitmap[dx / 8] << (dx % 8)) & 0x80u) {
+				row[dx] = value;
+			}
+		}
+		bitmap += bytes_per_row;
+		row += stride;
+	}
+}
+
+template <PixelFormat Format>
+void FrameBufferPixelWriter<Format>::WriteImage(const Vector2D<int>& pos,
+		const uint32_t* pixels, int width, int height) {
+	const Rectangle<int> rect = Clip(pos, {width, height});
+	if (IsEmpty(rect)) {
+		return;
+	}
+	MarkDamaged(rect.pos, rect.size);
+	const uint32_t stride = PixelsPerScanLine();
+	pixels += width * (rect.pos.y - pos.y) + (rect.pos.x - pos.x);
+	uint32_t* row = reinterpret_cast<uint32_t*>(PixelAt(rect.pos.x, rect.pos.y));
+	if (IsVideoMemory()) {
+		for (int dy = 0; dy < rect.size.y; ++dy) {
+			StreamCopySpan32(row, pixels, rect.size.x);
+			pixels += width;
+			row += stride;
+		}
+		StreamFence();
+	} else if (rect.size.x == 8) {
+		// 잘리지 않은 글꼴 1행 (8픽셀 = 32바이트): 고정 크기 복사로 rep movs의 기동 비용 회피
+		for (int dy = 0; dy < rect.size.y; ++dy) {
+			memcpy(row, pixels, 8 * sizeof(uint32_t));
+			pixels += width;
+			row += stride;
+		}
+	} else {
+		for (int dy = 0; dy < rect.size.y; ++dy) {
+			CopySpan32(row, pixels, rect.size.x);
+			pixels += width;
+			row += stride;
+		}
+	}
+}
+
+template <PixelFormat Format>
+void FrameBufferPixelWriter<Format>::Move(const Vector2D<int>& dst_pos,
+		const Rectangle<int>& src) {
+	// 원본은 writer 범위로, 이동 후 영역은 clip으로 자르고, 잘린 만큼 원본도 맞춰서 줄임
+	const Rectangle<int> visible_src = src & Bounds();
+	const Vector2D<int> offset{dst_pos.x - src.pos.x, dst_pos.y - src.pos.y};
+	const Rectangle<int> dst =
+		Clip({visible_src.pos.x + offset.x, visible_src.pos.y + offset.y}, visible_src.size);
+	if (IsEmpty(dst)) {
+		return;
+	}
+	MarkDamaged(dst.pos, dst.size);
+	const uint32_t stride = PixelsPerScanLine();
+	uint8_t* dst_row = PixelAt(dst.pos.x, dst.pos.y);
+	const uint8_t* src_row = PixelAt(dst.pos.x - offset.x, dst.pos.y - offset.y);
+	const size_t bytes_per_row = 4 * dst.size.x;
+	if (dst.size.x == static_cast<int>(stride)) {
+		// 행 전체 폭이면 영역이 메모리상 연속 -> memmove 1회
+		memmove(dst_row, src_row, bytes_per_row * dst.size.y);
+		return;
+	}
+	// 아래로 옮길 때는 아래 행부터 복사해야 아직 옮기지 않은 행을 덮어쓰지 않음
+	ptrdiff_t step = 4 * static_cast<ptrdiff_t>(stride);
+	if (offset.y > 0) {
+		dst_row += step * (dst.size.y - 1);
+		src_row += step * (dst.size.y - 1);
+		step = -step;
 	}
-	for (int dy = 1; dy < size.y - 1; ++dy) {
-		writer.Write(pos.x, pos.y + dy, c);
-		writer.Write(pos.x + size.x - 1, pos.y + dy, c);
+	for (int dy = 0; dy < dst.size.y; ++dy) {
+		memmove(dst_row, src_row, bytes_per_row);
+		dst_row += step;
+		src_row += step;
+	}
+}
+
+// #@@range_begin(instantiate_writers)
+template class FrameBufferPixelWriter<kPixelRGBResv8BitPerColor>;
+template class FrameBufferPixelWriter<kPixelBGRResv8BitPerColor>;
+// #@@range_end(instantiate_writers)
+
+// #@@range_begin(new_pixel_writer)
+PixelWriter* NewPixelWriter(PixelWriterStorage& storage, const FrameBufferConfig& config,
+                            bool video_memory) {
+	switch (config.pixel_format) {
+		case kPixelRGBResv8BitPerColor:
+			return new(storage.buf) RGBResv8BitPerColorPixelWriter{config, video_memory};
+		case kPixelBGRResv8BitPerColor:
+			return new(storage.buf) BGRResv8BitPerColorPixelWriter{config, video_memory};
 	}
+	return nullptr;
+}
+// #@@range_end(new_pixel_writer)
+
+// #@@range_begin(draw_rectangle)
+void DrawRectangle(PixelWriter& writer, const Vector2D<int>& pos, const Vector2D<int>& size, const PixelColor& c) {
+	writer.DrawRectangle(pos, size, c);
 }
 // #@@range_end(draw_rectangle)
 
 // #@@range_begin(fill_rectangle)
 void FillRectangle(PixelWriter& writer, const Vector2D<int>& pos, const Vector2D<int>& size, const PixelColor& c) {
-	for (int dy = 0; dy < size.y; ++dy) {
-		for (int dx = 0; dx < size.x; ++dx) {
-			writer.Write(pos.x + dx, pos.y + dy, c);
-		}
-	}
+	writer.FillRectangle(pos, size, c);
 }
-// #@@range_end(fill_rectangle)
\ No newline at end of file
+// #@@range_end(fill_rectangle)
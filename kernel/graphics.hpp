@@ -1,6 +1,7 @@
 #pragma once
 
 // #@@range_begin(pixel_color_def)
+#include <cstddef>
 #include "frame_buffer_config.hpp"
 
 struct PixelColor {
@@ -8,52 +9,268 @@ struct PixelColor {
 };
 // #@@range_end(pixel_color_def)
 
+// #@@range_begin(vector2d)
+template <typename T>
+struct Vector2D {
+	T x, y;
+	template <typename U>
+	Vector2D<T>& operator +=(const Vector2D<U>& rhs) {
+		x += rhs.x;
+		y += rhs.y;
+		return *this;
+	}
+};
+// #@@range_end(vector2d)
+
+// #@@range_begin(rectangle)
+template <typename T>
+struct Rectangle {
+	Vector2D<T> pos, size;
+};
+
+// 두 사각형의 교집합 (겹치지 않으면 size가 0인 사각형)
+template <typename T>
+Rectangle<T> operator &(const Rectangle<T>& lhs, const Rectangle<T>& rhs) {
+	const T left = lhs.pos.x > rhs.pos.x ? lhs.pos.x : rhs.pos.x;
+	const T top = lhs.pos.y > rhs.pos.y ? lhs.pos.y : rhs.pos.y;
+	const T lhs_right = lhs.pos.x + lhs.size.x, rhs_right = rhs.pos.x + rhs.size.x;
+	const T lhs_bottom = lhs.pos.y + lhs.size.y, rhs_bottom = rhs.pos.y + rhs.size.y;
+	const T right = lhs_right < rhs_right ? lhs_right : rhs_right;
+	const T bottom = lhs_bottom < rhs_bottom ? lhs_bottom : rhs_bottom;
+	if (right <= left || bottom <= top) {
+		return {{left, top}, {0, 0}};
+	}
+	return {{left, top}, {right - left, bottom - top}};
+}
+
+// 두 사각형을 모두 포함하는 최소 사각형
+template <typename T>
+Rectangle<T> operator |(const Rectangle<T>& lhs, const Rectangle<T>& rhs) {
+	const T left = lhs.pos.x < rhs.pos.x ? lhs.pos.x : rhs.pos.x;
+	const T top = lhs.pos.y < rhs.pos.y ? lhs.pos.y : rhs.pos.y;
+	const T lhs_right = lhs.pos.x + lhs.size.x, rhs_right = rhs.pos.x + rhs.size.x;
+	const T lhs_bottom = lhs.pos.y + lhs.size.y, rhs_bottom = rhs.pos.y + rhs.size.y;
+	const T right = lhs_right > rhs_right ? lhs_right : rhs_right;
+	const T bottom = lhs_bottom > rhs_bottom ? lhs_bottom : rhs_bottom;
+	return {{left, top}, {right - left, bottom - top}};
+}
+
+template <typename T>
+bool IsEmpty(const Rectangle<T>& rect) {
+	return rect.size.x <= 0 || rect.size.y <= 0;
+}
+// #@@range_end(rectangle)
+
+class DamageTracker;
+
+// #@@range_begin(image_view)
+/* 32bit 픽셀 이미지 (window 버퍼, sprite 등)를 가리키는 view, 소유 X
+픽셀은 그리는 대상과 같은 포맷으로 encode된 값, 예약 바이트 (bit 24~31)는 alpha로 사용 가능 */
+struct ImageView {
+	const uint32_t* pixels;
+	int width, height;
+	int stride; // 행 간격 (픽셀 수)
+};
+
+enum class BlitMode {
+	kOpaque,   // 그대로 복사
+	kColorKey, // key와 같은 픽셀은 건너뜀 (아래가 그대로 보임)
+	kAlpha,    // 예약 바이트를 alpha (0: 투명 ~ 255: 불투명)로 아래와 합성
+};
+// #@@range_end(image_view)
+
+// #@@range_begin(render_counters)
+/* 그리기 경로마다 직접 더하는 누적 카운터 (frame 단위 집계, 표시는 render_stats.hpp)
+cursor, 콘솔 등이 필요 이상으로 다시 그리게 된 회귀를 숫자로 확인하기 위한 것 */
+struct RenderCounters {
+	uint64_t pixels_written;    // PixelWriter 명령이 덮은 픽셀 (window 버퍼, shadow buffer 모두)
+	uint64_t composite_pixels;  // layer 합성으로 window에서 화면에 복사한 픽셀
+	uint64_t flush_bytes;       // Flush로 shadow buffer에서 VRAM에 복사한 바이트
+	uint64_t glyphs_drawn;      // 그린 글자 수
+	uint64_t glyphs_rasterized; // 글꼴 캐시에 새로 전개한 글자 수
+};
+
+extern RenderCounters render_counters;
+// #@@range_end(render_counters)
+
+// #@@range_begin(span_primitives)
+/* 같은 행에 연속한 32bit 픽셀 구간 (span) 단위의 채우기, 복사
+Fill/CopySpan32: 일반 메모리용 (rep stos / rep movs)
+StreamFill/StreamCopySpan32: VRAM용 non-temporal store (movnti, movntdq)
+-> Stream 계열 사용 후에는 StreamFence()로 store 순서 보장 */
+void FillSpan32(uint32_t* dst, uint32_t value, size_t count);
+void CopySpan32(uint32_t* dst, const uint32_t* src, size_t count);
+void StreamFillSpan32(uint32_t* dst, uint32_t value, size_t count);
+void StreamCopySpan32(uint32_t* dst, const uint32_t* src, size_t count);
+void StreamFence();
+// #@@range_end(span_primitives)
+
 // #@@range_begin(pixel_writer)
+/* 픽셀 1개마다 가상 함수를 호출하면 1920x1080 배경 채우기만으로 약 200만 번의 간접 호출 발생
+-> 사각형, 비트맵 같은 도형 단위 primitive를 가상 함수로 두고 (호출은 도형당 1회)
+   내부 루프는 픽셀 포맷별로 인스턴스화된 FrameBufferPixelWriter<Format>가 담당 */
 class PixelWriter {
  public:
-	PixelWriter(const FrameBufferConfig& config) : config_{config} { // 생성자
+	/* video_memory: 쓰기 대상이 GOP 프레임 버퍼 (write-combining VRAM)이면 true
+	-> 도형 primitive가 캐시를 오염시키지 않는 non-temporal store 사용 */
+	PixelWriter(const FrameBufferConfig& config, bool video_memory = false)
+		: config_{config}, video_memory_{video_memory}, clip_{Bounds()} { // 생성자
 	} // 프레임 버퍼의 구성 정보를 받아 클래스 멤버 변수 config_에 복사
 	// FrameBufferConfig의 내용을 그대로 복사 X, 포인터를 복사하는 것
 	// 즉, Write 할때, 구성 정보 전달 필요 X
 	virtual ~PixelWriter() = default; // 소멸자
 	virtual void Write(int x, int y, const PixelColor& c) = 0; // 순수 가상 함수 "= 0"
 
+	virtual void FillRectangle(const Vector2D<int>& pos, const Vector2D<int>& size,
+	                           const PixelColor& c) = 0;
+	virtual void DrawRectangle(const Vector2D<int>& pos, const Vector2D<int>& size,
+	                           const PixelColor& c) = 0;
+	/* 1bpp 비트맵 (행마다 (width + 7) / 8 바이트, MSB가 왼쪽 픽셀)에서
+	비트가 1인 픽셀만 c로 그리기 (폰트, 커서 모양 등) */
+	virtual void WriteMonochrome(const Vector2D<int>& pos, const uint8_t* bitmap,
+	                             int width, int height, const PixelColor& c) = 0;
+	/* 이 writer의 픽셀 포맷으로 미리 encode한 width x height 이미지 (행 간격 = width)를
+	변환 없이 행 단위로 복사 (글꼴 캐시 등) */
+	virtual void WriteImage(const Vector2D<int>& pos, const uint32_t* pixels,
+	                        int width, int height) = 0;
+	/* src 이미지의 src_area 부분을 pos에 mode로 복사 (BitBlt), 이미지 범위, clip 밖은 잘라냄
+	행 단위 kernel은 실행 시 CPU에 맞게 선택 (SSE2/AVX2, blit.hpp) -> 구현은 blit.cpp */
+	void BitBlt(const Vector2D<int>& pos, const ImageView& src, const Rectangle<int>& src_area,
+	            BlitMode mode, uint32_t color_key = 0);
+	/* 같은 버퍼 안의 src 영역을 dst_pos로 이동 (겹쳐도 됨, 스크롤 등)
+	다시 그리지 않고 픽셀 행을 그대로 옮김 */
+	virtual void Move(const Vector2D<int>& dst_pos, const Rectangle<int>& src) = 0;
+
+	PixelFormat GetPixelFormat() const {
+		return config_.pixel_format;
+	}
+	int Width() const {
+		return config_.horizontal_resolution;
+	}
+	int Height() const {
+		return config_.vertical_resolution;
+	}
+	Rectangle<int> Bounds() const {
+		return {{0, 0}, {Width(), Height()}};
+	}
+
+	/* 이후의 모든 primitive는 clip (writer 좌표) 안에만 그림, 초기값은 writer 전체 (Bounds)
+	범위 검사는 primitive마다 사각형 교집합 1회 -> 내부 루프는 픽셀마다 분기하지 않음 */
+	void SetClipRect(const Rectangle<int>& clip) {
+		clip_ = clip & Bounds();
+	}
+	void ResetClipRect() {
+		clip_ = Bounds();
+	}
+	const Rectangle<int>& ClipRect() const {
+		return clip_;
+	}
+
+	/* 설정하면 primitive마다 그린 영역을 tracker에 기록 (shadow buffer -> VRAM flush 대상)
+	기록은 primitive당 1회, 픽셀 단위 X */
+	void SetDamageTracker(DamageTracker* tracker) {
+		damage_ = tracker;
+	}
+
  protected:
 	uint8_t* PixelAt(int x, int y) {
 		return config_.frame_buffer + 4 * (config_.pixels_per_scan_line * y + x);
 	}
+	uint32_t PixelsPerScanLine() const {
+		return config_.pixels_per_scan_line;
+	}
+	bool IsVideoMemory() const {
+		return video_memory_;
+	}
+	// 그린 (clip 후) 영역을 damage에 기록, render_counters.pixels_written에 더함
+	void MarkDamaged(const Vector2D<int>& pos, const Vector2D<int>& size);
+	// {pos, size} 중 clip 안에 들어가는 부분 (비어 있으면 그릴 것 없음)
+	Rectangle<int> Clip(const Vector2D<int>& pos, const Vector2D<int>& size) const {
+		return Rectangle<int>{pos, size} & clip_;
+	}
+	bool InClip(int x, int y) const {
+		return clip_.pos.x <= x && x < clip_.pos.x + clip_.size.x &&
+			clip_.pos.y <= y && y < clip_.pos.y + clip_.size.y;
+	}
 
  private:
 	const FrameBufferConfig& config_;
+	const bool video_memory_;
+	DamageTracker* damage_ = nullptr;
+	Rectangle<int> clip_;
 };
 // #@@range_end(pixel_writer)
 
 // #@@range_begin(pixel_writer_def)
-class RGBResv8BitPerColorPixelWriter : public PixelWriter {
+/* 픽셀 포맷을 템플릿 인자로 고정 -> Encode가 컴파일 타임에 결정되어
+내부 루프는 32bit store의 나열이 됨 (포맷 선택은 KernelMain에서 1회) */
+template <PixelFormat Format>
+class FrameBufferPixelWriter : public PixelWriter {
  public:
 	using PixelWriter::PixelWriter; // 부모 생성자 사용
-	virtual void Write(int x, int y, const PixelColor& c) override; // override
-};
 
-class BGRResv8BitPerColorPixelWriter : public PixelWriter {
- public:
-	using PixelWriter::PixelWriter; // 부모 생성자 사용
-	virtual void Write(int x, int y, const PixelColor& c) override; // override
+	// 1픽셀 (4바이트)을 프레임 버퍼 메모리 배치 그대로의 32bit 값으로 변환
+	static constexpr uint32_t Encode(const PixelColor& c);
+
+	void Write(int x, int y, const PixelColor& c) override { // override
+		if (!InClip(x, y)) {
+			return;
+		}
+		*reinterpret_cast<uint32_t*>(PixelAt(x, y)) = Encode(c);
+		MarkDamaged({x, y}, {1, 1});
+	}
+	void FillRectangle(const Vector2D<int>& pos, const Vector2D<int>& size,
+	                   const PixelColor& c) override;
+	void DrawRectangle(const Vector2D<int>& pos, const Vector2D<int>& size,
+	                   const PixelColor& c) override;
+	void WriteMonochrome(const Vector2D<int>& pos, const uint8_t* bitmap,
+	                     int width, int height, const PixelColor& c) override;
+	void WriteImage(const Vector2D<int>& pos, const uint32_t* pixels,
+	                int width, int height) override;
+	void Move(const Vector2D<int>& dst_pos, const Rectangle<int>& src) override;
+
+ private:
+	// clip 완료된 rect를 value로 채움 (범위 검사, damage 기록 X)
+	void FillClipped(const Rectangle<int>& rect, uint32_t value);
 };
+
+// 메모리 배치 (낮은 주소부터): R, G, B, 예약
+template <>
+constexpr uint32_t FrameBufferPixelWriter<kPixelRGBResv8BitPerColor>::Encode(const PixelColor& c) {
+	return c.r | (c.g << 8) | (c.b << 16);
+}
+
+// 메모리 배치 (낮은 주소부터): B, G, R, 예약
+template <>
+constexpr uint32_t FrameBufferPixelWriter<kPixelBGRResv8BitPerColor>::Encode(const PixelColor& c) {
+	return c.b | (c.g << 8) | (c.r << 16);
+}
+
+// 포맷이 실행 시에만 결정되는 곳 (투명색 비교 등)에서 쓰는 encode
+inline uint32_t EncodePixel(PixelFormat format, const PixelColor& c) {
+	return format == kPixelRGBResv8BitPerColor
+		? FrameBufferPixelWriter<kPixelRGBResv8BitPerColor>::Encode(c)
+		: FrameBufferPixelWriter<kPixelBGRResv8BitPerColor>::Encode(c);
+}
+
+// 실체화는 graphics.cpp에서 두 포맷에 대해서만 수행
+extern template class FrameBufferPixelWriter<kPixelRGBResv8BitPerColor>;
+extern template class FrameBufferPixelWriter<kPixelBGRResv8BitPerColor>;
+
+using RGBResv8BitPerColorPixelWriter = FrameBufferPixelWriter<kPixelRGBResv8BitPerColor>;
+using BGRResv8BitPerColorPixelWriter = FrameBufferPixelWriter<kPixelBGRResv8BitPerColor>;
 // #@@range_end(pixel_writer_def)
 
-// #@@range_begin(vector2d)
-template <typename T>
-struct Vector2D {
-	T x, y;
-	template <typename U>
-	Vector2D<T>& operator +=(const Vector2D<U>& rhs) {
-		x += rhs.x;
-		y += rhs.y;
-		return *this;
-	}
+// #@@range_begin(new_pixel_writer)
+// 어떤 포맷의 writer든 담을 수 있는 크기의 메모리 (heap이 없으므로 placement new로 생성)
+struct PixelWriterStorage {
+	alignas(RGBResv8BitPerColorPixelWriter) char buf[sizeof(RGBResv8BitPerColorPixelWriter)];
 };
-// #@@range_end(vector2d)
+
+// config의 픽셀 포맷에 맞는 writer를 storage에 생성, 지원하지 않는 포맷이면 nullptr
+PixelWriter* NewPixelWriter(PixelWriterStorage& storage, const FrameBufferConfig& config,
+                            bool video_memory);
+// #@@range_end(new_pixel_writer)
 
 void DrawRectangle(PixelWriter& writer, const Vector2D<int>& pos, const Vector2D<int>& size, const PixelColor& c);
-void FillRectangle(PixelWriter& writer, const Vector2D<int>& pos, const Vector2D<int>& size, const PixelColor& c);
\ No newline at end of file
+void FillRectangle(PixelWriter& writer, const Vector2D<int>& pos, const Vector2D<int>& size, const PixelColor& c);
@@ -67,6 +67,8 @@ class InterruptVector {
  public:
 	enum Number {
 		kXHCI = 0x40,
+		kSerial = 0x41,
+		kLAPICTimer = 0x42,
 	};
 };
 // #@@range_end(vector_numbers)
@@ -0,0 +1,28 @@
+#include "ioapic.hpp"
+
+#include "asmfunc.h"
+
+namespace {
+	// IOREGSEL에 레지스터 번호를 쓰고 IOWIN으로 읽고 씀
+	void WriteRegister(uint32_t index, uint32_t value) {
+		auto base = reinterpret_cast<volatile uint32_t*>(ioapic::kDefaultBase);
+		base[0] = index; // IOREGSEL
+		base[4] = value; // IOWIN (base + 0x10)
+	}
+
+	const uint32_t kRedirectionTable = 0x10; // 입력 핀 n: 0x10 + 2n (하위), 0x11 + 2n (상위)
+}
+
+namespace ioapic {
+	void DisableLegacyPIC() {
+		IoOut8(0xa1, 0xff); // slave PIC의 IMR
+		IoOut8(0x21, 0xff); // master PIC의 IMR
+	}
+
+	void RouteISAIRQ(uint8_t irq, uint8_t vector, uint8_t apic_id) {
+		// 상위: bit 56-63 destination (physical mode의 APIC ID)
+		WriteRegister(kRedirectionTable + 2 * irq + 1, static_cast<uint32_t>(apic_id) << 24);
+		// 하위: vector, delivery mode 000 (fixed), physical, active high, edge, mask 0
+		WriteRegister(kRedirectionTable + 2 * irq, vector);
+	}
+}
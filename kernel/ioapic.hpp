@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+// #@@range_begin(ioapic)
+/* I/O APIC: ISA IRQ (COM1 등 레거시 장치의 interrupt)를 Local APIC의 vector로 전달
+MSI를 쓰는 PCI 장치 (xHC)와 달리 레거시 장치는 I/O APIC의 redirection table 설정이 필요
+ACPI (MADT)를 읽지 않으므로 주소는 표준 위치 0xfec00000, ISA IRQ n = 입력 핀 n으로 가정 (QEMU, 대부분의 PC)
+IRQ 0 (PIT)은 보통 핀 2로 연결되므로 이 함수로 설정 X */
+namespace ioapic {
+	const uintptr_t kDefaultBase = 0xfec00000;
+
+	// 8259 PIC의 모든 IRQ를 mask (I/O APIC과 같은 interrupt가 중복 전달되지 않게)
+	void DisableLegacyPIC();
+	// ISA IRQ irq -> apic_id의 core에 vector로 전달 (edge, active high, fixed)
+	void RouteISAIRQ(uint8_t irq, uint8_t vector, uint8_t apic_id);
+}
+// #@@range_end(ioapic)
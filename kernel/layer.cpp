@@ -0,0 +1,235 @@
+#include "layer.hpp"
+
+namespace {
+	bool Contains(const Rectangle<int>& outer, const Rectangle<int>& inner) {
+		return outer.pos.x <= inner.pos.x && outer.pos.y <= inner.pos.y &&
+		       inner.pos.x + inner.size.x <= outer.pos.x + outer.size.x &&
+		       inner.pos.y + inner.size.y <= outer.pos.y + outer.size.y;
+	}
+}
+
+// #@@range_begin(layer_impl)
+Layer::Layer(unsigned int id) : id_{id} {
+}
+
+unsigned int Layer::ID() const {
+	return id_;
+}
+
+Layer& Layer::SetWindow(Window* window) {
+	window_ = window;
+	return *this;
+}
+
+Window* Layer::GetWindow() const {
+	return window_;
+}
+
+Vector2D<int> Layer::GetPosition() const {
+	return pos_;
+}
+
+Layer& Layer::Move(Vector2D<int> pos) {
+	pos_ = pos;
+	return *this;
+}
+
+Layer& Layer::MoveRelative(Vector2D<int> pos_diff) {
+	pos_ += pos_diff;
+	return *this;
+}
+
+Rectangle<int> Layer::Area() const {
+	if (!window_) {
+		return {pos_, {0, 0}};
+	}
+	return {pos_, {window_->Width(), window_->Height()}};
+}
+
+bool Layer::Covers(const Rectangle<int>& area) const {
+	if (!window_ || !window_->IsOpaque()) {
+		return false;
+	}
+	return Contains(Area(), area);
+}
+
+void Layer::DrawTo(FrameBuffer& screen, const Rectangle<int>& area) const {
+	if (window_) {
+		window_->DrawTo(screen, pos_, area);
+	}
+}
+// #@@range_end(layer_impl)
+
+// #@@range_begin(layer_manager_impl)
+void LayerManager::SetScreen(FrameBuffer* screen) {
+	screen_ = screen;
+}
+
+void LayerManager::SetSprite(Sprite* sprite) {
+	sprite_ = sprite;
+}
+
+Layer* LayerManager::NewLayer() {
+	if (num_layers_ == kMaxLayers) {
+		return nullptr;
+	}
+	++latest_id_;
+	layers_[num_layers_] = Layer{latest_id_};
+	return &layers_[num_layers_++];
+}
+
+void LayerManager::Draw(const Rectangle<int>& area) const {
+	if (IsEmpty(area)) {
+		return;
+	}
+	// 위에서부터 area를 모두 가리는 layer 찾기 (콘솔이 바뀌면 바탕화면은 합성하지 않음)
+	int bottom = 0;
+	for (int i = stack_size_ - 1; i > 0; --i) {
+		if (layer_stack_[i]->Covers(area)) {
+			bottom = i;
+			break;
+		}
+	}
+	for (int i = bottom; i < stack_size_; ++i) {
+		layer_stack_[i]->DrawTo(*screen_, area);
+	}
+	if (sprite_) { // 재합성으로 덮어쓴 sprite 부분을 다시 저장, 그리기
+		sprite_->Refresh(*screen_, area);
+	}
+}
+
+void LayerManager::Draw(unsigned int id) const {
+	if (auto layer = FindLayer(id)) {
+		Draw(layer->Area());
+	}
+}
+
+void LayerManager::Draw(unsigned int id, const Rectangle<int>& area) const {
+	if (auto layer = FindLayer(id)) {
+		Rectangle<int> screen_area = area;
+		screen_area.pos += layer->GetPosition();
+		Draw(screen_area & layer->Area());
+	}
+}
+
+void LayerManager::MoveArea(unsigned int id, Vector2D<int> dst_pos, const Rectangle<int>& src) const {
+	auto layer = FindLayer(id);
+	const int height = GetHeight(id);
+	if (layer == nullptr || height < 0) {
+		return;
+	}
+	const Vector2D<int> offset{dst_pos.x - src.pos.x, dst_pos.y - src.pos.y};
+	Rectangle<int> screen_src = src;
+	screen_src.pos += layer->GetPosition();
+	Rectangle<int> screen_dst = screen_src;
+	screen_dst.pos += offset;
+	const Rectangle<int> moved = screen_src | screen_dst;
+	if (!layer->Covers(moved) || !Contains(screen_->Writer().Bounds(), moved)) {
+		Draw(screen_dst & layer->Area());
+		return;
+	}
+
+	screen_->Writer().Move(screen_dst.pos, screen_src); // damage는 screen_dst (Flush로 VRAM에 복사)
+	// 위 layer, sprite도 함께 옮겨졌음 -> 원래 자리와 옮겨진 자리 중 screen_dst 안쪽만 다시 합성
+	auto redraw = [&](Rectangle<int> area) {
+		Draw(area & screen_dst);
+		area.pos += offset;
+		Draw(area & screen_dst);
+	};
+	for (int i = height + 1; i < stack_size_; ++i) {
+		redraw(layer_stack_[i]->Area());
+	}
+	if (sprite_) {
+		redraw(sprite_->Area());
+	}
+}
+
+void LayerManager::Move(unsigned int id, Vector2D<int> new_position) {
+	auto layer = FindLayer(id);
+	if (layer == nullptr) {
+		return;
+	}
+	const Rectangle<int> old_area = layer->Area();
+	layer->Move(new_position);
+	if (GetHeight(id) < 0) {
+		return;
+	}
+	Draw(old_area); // 이전 위치: 아래 layer가 다시 보이도록
+	Draw(layer->Area());
+}
+
+void LayerManager::MoveRelative(unsigned int id, Vector2D<int> pos_diff) {
+	if (auto layer = FindLayer(id)) {
+		auto pos = layer->GetPosition();
+		pos += pos_diff;
+		Move(id, pos);
+	}
+}
+
+void LayerManager::UpDown(unsigned int id, int new_height) {
+	if (new_height < 0) {
+		Hide(id);
+		return;
+	}
+	auto layer = FindLayer(id);
+	if (layer == nullptr) {
+		return;
+	}
+
+	int old_height = GetHeight(id);
+	if (old_height < 0) { // 비표시 -> 표시: 빈자리를 하나 만들어 두고 삽입
+		layer_stack_[stack_size_++] = layer;
+		old_height = stack_size_ - 1;
+	}
+	if (new_height > stack_size_ - 1) {
+		new_height = stack_size_ - 1;
+	}
+
+	// old_height 위치를 비우고 new_height 위치로 밀어 넣기
+	if (old_height < new_height) {
+		for (int i = old_height; i < new_height; ++i) {
+			layer_stack_[i] = layer_stack_[i + 1];
+		}
+	} else {
+		for (int i = old_height; i > new_height; --i) {
+			layer_stack_[i] = layer_stack_[i - 1];
+		}
+	}
+	layer_stack_[new_height] = layer;
+}
+
+void LayerManager::Hide(unsigned int id) {
+	const int height = GetHeight(id);
+	if (height < 0) {
+		return;
+	}
+	for (int i = height; i < stack_size_ - 1; ++i) {
+		layer_stack_[i] = layer_stack_[i + 1];
+	}
+	--stack_size_;
+}
+
+Layer* LayerManager::FindLayer(unsigned int id) {
+	for (int i = 0; i < num_layers_; ++i) {
+		if (layers_[i].ID() == id) {
+			return &layers_[i];
+		}
+	}
+	return nullptr;
+}
+
+const Layer* LayerManager::FindLayer(unsigned int id) const {
+	return const_cast<LayerManager*>(this)->FindLayer(id);
+}
+
+int LayerManager::GetHeight(unsigned int id) const {
+	for (int h = 0; h < stack_size_; ++h) {
+		if (layer_stack_[h]->ID() == id) {
+			return h;
+		}
+	}
+	return -1;
+}
+// #@@range_end(layer_manager_impl)
+
+LayerManager* layer_manager;
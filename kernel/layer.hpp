@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+
+#include "frame_buffer.hpp"
+#include "graphics.hpp"
+#include "sprite.hpp"
+#include "window.hpp"
+
+/* 바탕화면, 콘솔, 마우스 커서를 각각 자신의 window (버퍼)를 가진 layer로 두고 겹쳐서 표시
+아래 layer부터 차례로 screen에 복사 -> 위 layer가 아래 layer를 덮음
+변경이 생기면 그 영역과 겹치는 layer의 해당 부분만 다시 합성 */
+
+// #@@range_begin(layer)
+class Layer {
+ public:
+	Layer(unsigned int id = 0);
+	unsigned int ID() const;
+
+	Layer& SetWindow(Window* window);
+	Window* GetWindow() const;
+	Vector2D<int> GetPosition() const;
+
+	// 위치만 변경, 화면 재합성은 LayerManager가 담당
+	Layer& Move(Vector2D<int> pos);
+	Layer& MoveRelative(Vector2D<int> pos_diff);
+
+	// 화면 좌표 기준으로 이 layer가 차지하는 영역
+	Rectangle<int> Area() const;
+	// 화면 좌표 area 전체를 불투명하게 덮으면 true (아래 layer는 합성하지 않아도 됨)
+	bool Covers(const Rectangle<int>& area) const;
+	// 화면 좌표 area와 겹치는 부분만 screen에 그리기
+	void DrawTo(FrameBuffer& screen, const Rectangle<int>& area) const;
+
+ private:
+	unsigned int id_;
+	Vector2D<int> pos_{0, 0};
+	Window* window_ = nullptr;
+};
+// #@@range_end(layer)
+
+// #@@range_begin(layer_manager)
+class LayerManager {
+ public:
+	static const int kMaxLayers = 16;
+
+	void SetScreen(FrameBuffer* screen);
+	// 모든 layer 위에 save-under 방식으로 그리는 sprite (마우스 커서)
+	void SetSprite(Sprite* sprite);
+	// 새 layer 생성 (처음에는 비표시, UpDown으로 높이를 지정하면 표시), kMaxLayers개를 넘으면 nullptr
+	Layer* NewLayer();
+
+	/* 화면 좌표 area 안에 있는 표시 중인 layer들을 아래부터 다시 합성
+	area 전체를 덮는 불투명 layer가 있으면 그 layer부터 (가려진 아래 layer는 건너뜀) */
+	void Draw(const Rectangle<int>& area) const;
+	// 지정한 layer가 차지하는 영역을 다시 합성
+	void Draw(unsigned int id) const;
+	// 지정한 layer 중 window 좌표 area 부분만 다시 합성 (콘솔의 바뀐 칸 등)
+	void Draw(unsigned int id, const Rectangle<int>& area) const;
+	/* 지정한 layer의 window 안에서 src (window 좌표)를 dst_pos로 옮긴 직후 호출 (콘솔 스크롤)
+	layer가 옮긴 범위를 불투명하게 덮고 있으면 이미 합성된 화면 픽셀도 그대로 옮김 -> 재합성 X
+	위 layer, sprite와 겹치는 부분만 다시 합성, 덮지 않으면 옮겨진 영역 전체를 다시 합성 */
+	void MoveArea(unsigned int id, Vector2D<int> dst_pos, const Rectangle<int>& src) const;
+
+	// 이동 전 영역과 이동 후 영역만 다시 합성 -> 비용은 layer 크기 정도
+	void Move(unsigned int id, Vector2D<int> new_position);
+	void MoveRelative(unsigned int id, Vector2D<int> pos_diff);
+
+	/* layer의 높이 (z 순서) 변경, 0이 가장 아래
+	음수면 비표시, 현재 최상위보다 크면 최상위로 */
+	void UpDown(unsigned int id, int new_height);
+	void Hide(unsigned int id);
+
+ private:
+	FrameBuffer* screen_ = nullptr;
+	Sprite* sprite_ = nullptr;
+	std::array<Layer, kMaxLayers> layers_{};
+	int num_layers_ = 0;
+	std::array<Layer*, kMaxLayers> layer_stack_{}; // 표시 중인 layer, 아래에서부터 순서대로
+	int stack_size_ = 0;
+	unsigned int latest_id_ = 0;
+
+	Layer* FindLayer(unsigned int id);
+	const Layer* FindLayer(unsigned int id) const;
+	int GetHeight(unsigned int id) const;
+};
+// #@@range_end(layer_manager)
+
+extern LayerManager* layer_manager;
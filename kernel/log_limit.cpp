@@ -0,0 +1,58 @@
+#include "log_limit.hpp"
+
+// #@@range_begin(log_limiter_check)
+bool LogLimiter::Check(const char* file, int line, uint64_t now) {
+	Site& site = FindOrAdd(file, line, now);
+	if (now - site.window_start >= window_) {
+		Report(site); // 지난 window의 억제 수 (있을 때만)
+		site.window_start = now;
+		site.logged_in_window = 0;
+	}
+	if (site.logged_in_window < kBurst) {
+		++site.logged_in_window;
+		++site.logged;
+		return true;
+	}
+	++site.pending;
+	++site.suppressed;
+	++suppressed_;
+	return false;
+}
+
+void LogLimiter::Flush(uint64_t now) {
+	for (auto& site : sites_) {
+		if (site.file && site.pending > 0 && now - site.window_start >= window_) {
+			Report(site);
+		}
+	}
+}
+// #@@range_end(log_limiter_check)
+
+LogLimiter::Site& LogLimiter::FindOrAdd(const char* file, int line, uint64_t now) {
+	Site* oldest = &sites_[0];
+	for (auto& site : sites_) {
+		if (site.file == file && site.line == line) {
+			return site;
+		}
+		if (!site.file) {
+			oldest = &site;
+			break;
+		}
+		if (site.window_start < oldest->window_start) {
+			oldest = &site;
+		}
+	}
+	// 빈 자리가 없으면 가장 오래된 site를 재사용: 남은 억제 수는 지금 출력
+	if (oldest->file) {
+		Report(*oldest);
+	}
+	*oldest = Site{file, line, now, 0, 0, 0, 0};
+	return *oldest;
+}
+
+void LogLimiter::Report(Site& site) {
+	if (site.pending > 0) {
+		report_(site.file, site.line, site.pending);
+		site.pending = 0;
+	}
+}
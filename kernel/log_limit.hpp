@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+
+// #@@range_begin(log_limiter)
+/* 같은 곳 (file, line)에서 반복되는 log를 줄이는 rate limiter
+site마다 window (기본 kWindowCycles, SetWindow로 변경, TSC cycle) 안에서 처음 kBurst개만 기록, 나머지는 세기만 함
+window가 끝난 뒤 그 site의 다음 log 또는 Flush에서 "repeated N times" 요약을 1줄 출력
+-> 매 이벤트마다 실패하는 경로 (ProcessEvent 등)에서 콘솔 그리기가 처리 시간을 잡아먹지 않음
+key는 file 포인터 + line (Error::File()/Line() 또는 __FILE__/__LINE__), site는 최대 kSites개
+가득 차면 가장 오래 전에 window를 시작한 site를 (요약 출력 후) 재사용
+main loop에서만 호출 (interrupt handler X: 표를 잠그지 않음) */
+class LogLimiter {
+ public:
+	static const int kSites = 16;
+	static const uint32_t kBurst = 5;
+	static const uint64_t kWindowCycles = 1ull << 31; // TSC 보정 전 기본값: 약 0.5 - 1초 (2 - 4GHz)
+
+	struct Site {
+		const char* file; // nullptr = 빈 자리
+		int line;
+		uint64_t window_start;
+		uint32_t logged_in_window;
+		uint64_t pending; // 아직 요약을 출력하지 않은 억제 수
+		uint64_t logged, suppressed; // 누계
+	};
+
+	// 억제된 log의 요약 출력 (file, line, 억제 수)
+	using ReportFunc = void (*)(const char* file, int line, uint64_t repeated);
+
+	explicit LogLimiter(ReportFunc report) : report_{report} {}
+	// 이 site의 log를 지금 (now = TSC) 기록해도 되면 true
+	bool Check(const char* file, int line, uint64_t now);
+	// window가 끝났는데 요약을 출력하지 않은 site의 요약 출력 (반복이 멈춘 경우용)
+	void Flush(uint64_t now);
+	// window 길이 (TSC cycle) 변경: 진행 중인 window에도 적용
+	void SetWindow(uint64_t cycles) { window_ = cycles; }
+
+	const Site& SiteAt(int i) const { return sites_[i]; }
+	uint64_t Suppressed() const { return suppressed_; } // 모든 site의 억제 누계
+
+ private:
+	Site& FindOrAdd(const char* file, int line, uint64_t now);
+	void Report(Site& site);
+
+	ReportFunc report_;
+	uint64_t window_ = kWindowCycles;
+	Site sites_[kSites] = {};
+	uint64_t suppressed_ = 0;
+};
+// #@@range_end(log_limiter)
@@ -0,0 +1,101 @@
+#include "log_ring.hpp"
+
+#include <cstring>
+
+// #@@range_begin(log_ring_write)
+bool LogRing::Write(const char* s, size_t len, uint32_t tag) {
+	if (len > kMaxRecord) {
+		len = kMaxRecord;
+	}
+	char* record = Reserve(len);
+	if (!record) {
+		Drop();
+		return false;
+	}
+	memcpy(record, s, len);
+	Commit(record, len, tag);
+	return true;
+}
+
+char* LogRing::Reserve(size_t len) {
+	if (len > kMaxRecord) {
+		len = kMaxRecord;
+	}
+	const uint64_t size = RecordSize(len);
+
+	// 1. [start, start + size) 예약: ring 끝을 넘으면 끝까지를 padding으로 함께 예약
+	uint64_t pos = reserve_pos_.load(std::memory_order_relaxed);
+	uint64_t start;
+	do {
+		const uint64_t rest = kBytes - pos % kBytes;
+		start = rest < size ? pos + rest : pos;
+		if (start + size - read_pos_.load(std::memory_order_acquire) > kBytes) {
+			return nullptr;
+		}
+	} while (!reserve_pos_.compare_exchange_weak(pos, start + size,
+	                                             std::memory_order_acq_rel,
+	                                             std::memory_order_relaxed));
+
+	// 2. 자기 영역에만 쓰고 마지막에 완료 표시 (읽는 쪽은 state를 본 뒤에 내용을 읽음)
+	if (start != pos) {
+		Header* pad = HeaderAt(pos);
+		pad->size = start - pos;
+		pad->length = 0;
+		pad->state.store(kPadding, std::memory_order_release);
+	}
+	Header* header = HeaderAt(start);
+	header->size = size;
+	return reinterpret_cast<char*>(header + 1);
+}
+
+void LogRing::Commit(char* record, size_t length, uint32_t tag) {
+	Header* header = reinterpret_cast<Header*>(record) - 1;
+	const uint64_t size = RecordSize(length);
+	if (size < header->size) {
+		/* 이 기록이 마지막 예약이면 (reserve_pos_가 이 기록의 끝) 끝을 당김
+		아직 Commit 전이라 read_pos_ <= 이 기록의 시작 -> 끝 위치는 % kBytes로 비교해도 1바퀴 차이 X */
+		const uint64_t offset = reinterpret_cast<char*>(header) - data_;
+		uint64_t end = reserve_pos_.load(std::memory_order_relaxed);
+		if (end % kBytes == (offset + header->size) % kBytes &&
+		    reserve_pos_.compare_exchange_strong(end, end - (header->size - size),
+		                                         std::memory_order_relaxed)) {
+			header->size = size; // 반납한 자리는 Read가 0으로 만든 상태 그대로
+		}
+	}
+	header->length = length;
+	header->tag = tag;
+	header->state.store(kCommitted, std::memory_order_release);
+}
+// #@@range_end(log_ring_write)
+
+// #@@range_begin(log_ring_read)
+size_t LogRing::Read(char* buf, size_t buf_size, uint32_t* tag) {
+	while (true) {
+		const uint64_t pos = read_pos_.load(std::memory_order_relaxed);
+		if (pos == reserve_pos_.load(std::memory_order_acquire)) {
+			return 0;
+		}
+		Header* header = HeaderAt(pos);
+		const uint32_t state = header->state.load(std::memory_order_acquire);
+		if (state == kEmpty) { // 예약한 쪽이 아직 쓰는 중 (이 main loop가 끼어든 상태)
+			return 0;
+		}
+
+		const uint32_t size = header->size;
+		size_t copied = 0;
+		if (state == kCommitted) {
+			copied = header->length < buf_size ? header->length : buf_size;
+			memcpy(buf, header + 1, copied);
+			if (tag) {
+				*tag = header->tag;
+			}
+		}
+		// 다음 바퀴의 기록이 이 자리를 예약했을 때 옛 내용을 완료된 header로 오인하지 않도록 0으로
+		memset(static_cast<void*>(header), 0, size);
+		read_pos_.store(pos + size, std::memory_order_release);
+		if (state == kCommitted) {
+			return copied;
+		}
+	}
+}
+// #@@range_end(log_ring_read)
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// #@@range_begin(log_ring)
+/* 포맷이 끝난 log 문자열을 쌓아 두는 고정 크기 원형 버퍼 (lock 없음)
+Write: 어디서든 호출 가능 (interrupt handler, 그 handler가 끼어든 Write 도중 포함)
+	-> 위치 예약은 compare-exchange 1회, 이후는 자기 영역에 memcpy + 완료 표시뿐
+Read: 읽는 쪽은 main loop 하나 (여러 곳에서 동시에 호출 X)
+	예약만 되고 아직 완료되지 않은 기록에서 멈춤 -> 끼어든 쪽의 기록이 먼저 끝나도 순서는 예약 순
+가득 차면 새 기록을 버리고 버린 개수만 셈 (쓰는 쪽은 기다리지 않음) */
+class LogRing {
+ public:
+	static const size_t kBytes = 64 * 1024; // 2의 거듭제곱
+	static const size_t kMaxRecord = 1024; // 이보다 긴 문자열은 잘라서 보관
+
+	// 공간이 없으면 false (Dropped가 1 증가), tag는 기록과 함께 보관해서 Read가 돌려주는 값 (logger: LogLevel)
+	bool Write(const char* s, size_t len, uint32_t tag = 0);
+	/* len바이트 (kMaxRecord까지) 자리를 예약하고 그 주소를 반환, 공간이 없으면 nullptr
+	예약한 쪽은 직접 채운 뒤 반드시 Commit (그 전까지 Read는 이 기록에서 멈춤)
+	-> 포맷 결과를 중간 버퍼 없이 ring에 바로 쓰기 위함 */
+	char* Reserve(size_t len);
+	/* Reserve로 받은 자리에 length바이트 (예약한 길이 이하)를 썼음을 표시
+	그 뒤에 아무도 예약하지 않았으면 남는 자리는 반납 -> 최대 길이로 예약하고 바로 포맷해도 낭비 X */
+	void Commit(char* record, size_t length, uint32_t tag = 0);
+	// 예약에 실패해 기록을 버림 (Dropped가 1 증가)
+	void Drop() { dropped_.fetch_add(1, std::memory_order_relaxed); }
+	/* 가장 오래된 완료된 기록 1개를 buf에 복사하고 그 길이를 반환 (buf_size보다 길면 자름)
+	읽을 기록이 없으면 0, tag가 nullptr가 아니면 그 기록의 tag도 */
+	size_t Read(char* buf, size_t buf_size, uint32_t* tag = nullptr);
+	// 지금까지 버린 기록 수
+	uint64_t Dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+ private:
+	// 기록의 앞 16바이트, 기록 전체 크기도 16의 배수 (header가 ring 끝에서 잘리지 않음)
+	struct alignas(16) Header {
+		std::atomic<uint32_t> state;
+		uint32_t size; // header 포함, 정렬 후 크기
+		uint32_t length; // 문자열 길이 (padding이면 0)
+		uint32_t tag;
+	};
+	enum State : uint32_t {
+		kEmpty = 0, // 예약만 됐거나 아직 아무도 쓰지 않은 자리 (읽은 자리는 0으로 되돌림)
+		kCommitted = 1,
+		kPadding = 2, // ring 끝에 남은 자투리: 읽는 쪽은 건너뜀
+	};
+
+	// header 포함, 16의 배수
+	static uint64_t RecordSize(size_t len) {
+		return (sizeof(Header) + len + sizeof(Header) - 1) & ~(sizeof(Header) - 1);
+	}
+
+	Header* HeaderAt(uint64_t pos) {
+		return reinterpret_cast<Header*>(data_ + pos % kBytes);
+	}
+
+	std::atomic<uint64_t> reserve_pos_{0}; // 다음 기록이 예약될 위치 (감소 X, % kBytes로 사용)
+	std::atomic<uint64_t> read_pos_{0};
+	std::atomic<uint64_t> dropped_{0};
+	alignas(16) char data_[kBytes] = {};
+};
+// #@@range_end(log_ring)
@@ -1,33 +1,159 @@
 #include "logger.hpp"
 
 #include <cstddef>
-#include <cstdio>
+#include <cstring>
 
 #include "console.hpp"
+#include "format.hpp"
+#include "log_limit.hpp"
+#include "log_ring.hpp"
+#include "serial.hpp"
+#include "tsc.hpp"
+
+LogLevel log_levels[kLogSubsystemCount] = {kWarn, kWarn, kWarn, kWarn, kWarn, kWarn};
+static_assert(kLogSubsystemCount == 6, "LogSubsystem을 추가하면 log_levels의 초기값도 추가");
 
 namespace {
-	LogLevel log_level = kWarn;
+	LogRing log_ring;
+	uint64_t reported_dropped = 0; // DrainLog에서 이미 알린 버린 기록 수
+	unsigned log_sinks = kLogSinkConsole;
+	LogLevel console_level = kDebug; // 콘솔로 내보낼 가장 상세한 level
+	LogLevel serial_level = kDebug;
+
+	void ReportRepeated(const char* file, int line, uint64_t repeated) {
+		LogMessage(kWarn, "[%s:%d] last message repeated %lu times\n", file, line, repeated);
+	}
+
+	LogLimiter log_limiter{ReportRepeated};
 }
 
 extern Console* console;
+extern SerialPort* serial_port;
 
-void SetLogLevel(LogLevel level) {
-	log_level = level;
+void SetLogSinks(unsigned sinks) {
+	log_sinks = sinks;
 }
 
-int Log(LogLevel level, const char* format, ...) {
-	if (level > log_level) {
-		return 0;
+unsigned LogSinks() {
+	return log_sinks;
+}
+
+void SetLogSinkLevel(unsigned sinks, LogLevel level) {
+	if (sinks & kLogSinkConsole) {
+		console_level = level;
+	}
+	if (sinks & kLogSinkSerial) {
+		serial_level = level;
 	}
+}
 
-	va_list ap;
-	int result;
-	char s[1024];
+namespace {
+	// s는 null 종단, 길이 len
+	void Emit(LogLevel level, const char* s, size_t len) {
+		if ((log_sinks & kLogSinkConsole) && level <= console_level) {
+			console->PutString(s); // 화면 반영은 다음 RenderFrame에서
+		}
+		if ((log_sinks & kLogSinkSerial) && serial_port && level <= serial_level) {
+			serial_port->Write(s, len); // 송신은 interrupt에서
+		}
+	}
+}
+
+void SetLogLevel(LogLevel level) {
+	for (auto& l : log_levels) {
+		l = level;
+	}
+}
 
+void SetLogLevel(LogSubsystem subsystem, LogLevel level) {
+	log_levels[subsystem] = level;
+}
+
+int LogMessage(LogLevel level, const char* format, ...) {
+	va_list ap;
 	va_start(ap, format);
-	result = vsprintf(s, format, ap);
+	const int result = VWriteLog(level, format, ap);
 	va_end(ap);
+	return result;
+}
 
-	console->PutString(s);
+void WriteLog(LogLevel level, const char* s, size_t len) {
+	log_ring.Write(s, len, level);
+}
+
+namespace {
+	struct RecordContext {
+		char* pos;
+		char* end;
+	};
+
+	void RecordSink(void* context, const char* s, size_t len) {
+		auto c = static_cast<RecordContext*>(context);
+		const size_t n = len < static_cast<size_t>(c->end - c->pos) ? len : c->end - c->pos;
+		memcpy(c->pos, s, n);
+		c->pos += n;
+	}
+}
+
+int VWriteLog(LogLevel level, const char* format, va_list ap) {
+	// 최대 길이로 예약하고 바로 포맷 (남는 자리는 Commit에서 반납)
+	size_t len = LogRing::kMaxRecord;
+	char* record = log_ring.Reserve(len);
+	if (!record) {
+		// ring이 거의 찼을 때만: 길이를 먼저 세고 그만큼만 예약
+		va_list count_ap;
+		va_copy(count_ap, ap);
+		const int result = VFormatLength(format, count_ap);
+		va_end(count_ap);
+		len = result < static_cast<int>(LogRing::kMaxRecord) ? result : LogRing::kMaxRecord;
+		record = log_ring.Reserve(len);
+		if (!record) {
+			log_ring.Drop();
+			return result;
+		}
+	}
+	RecordContext context{record, record + len}; // 길이를 센 뒤 %s의 내용이 바뀌어도 예약한 길이까지만
+	const int result = VFormat(RecordSink, &context, format, ap);
+	log_ring.Commit(record, context.pos - record, level);
 	return result;
 }
+
+bool LogRateCheck(const char* file, int line) {
+	return log_limiter.Check(file, line, Now());
+}
+
+void SetLogRateWindow(uint64_t cycles) {
+	log_limiter.SetWindow(cycles);
+}
+
+uint64_t LogSuppressed() {
+	return log_limiter.Suppressed();
+}
+
+void LogSuppressionReport() {
+	LogMessage(kWarn, "log: %lu messages suppressed\n", log_limiter.Suppressed());
+	for (int i = 0; i < LogLimiter::kSites; ++i) {
+		const LogLimiter::Site& site = log_limiter.SiteAt(i);
+		if (site.file) {
+			LogMessage(kWarn, "  %s:%d logged %lu, suppressed %lu\n",
+			           site.file, site.line, site.logged, site.suppressed);
+		}
+	}
+}
+
+void DrainLog() {
+	char s[LogRing::kMaxRecord + 1];
+	log_limiter.Flush(Now()); // 요약도 이번에 함께 출력
+	uint32_t level;
+	while (size_t len = log_ring.Read(s, LogRing::kMaxRecord, &level)) {
+		s[len] = '\0';
+		Emit(static_cast<LogLevel>(level), s, len);
+	}
+
+	const uint64_t dropped = log_ring.Dropped();
+	if (dropped != reported_dropped) {
+		const int len = FormatToBuffer(s, sizeof(s), "[log: %lu messages dropped]\n", dropped - reported_dropped);
+		Emit(kWarn, s, len);
+		reported_dropped = dropped;
+	}
+}
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+
 enum LogLevel {
   kError = 3,
   kWarn  = 4,
@@ -7,9 +11,113 @@ enum LogLevel {
   kDebug = 7,
 };
 
-/* 글로벌 로그 우선순위 임계값 level로 설정,
+// #@@range_begin(log_subsystem)
+/* log를 남기는 쪽의 분류, 분류마다 실행 중 임계값을 따로 가짐
+파일 단위로 지정: 첫 #include 앞에 #define LOG_SUBSYSTEM kLogXHCI 등 (지정 없으면 kLogKernel) */
+enum LogSubsystem {
+  kLogKernel,
+  kLogPCI,
+  kLogUSB,
+  kLogXHCI,
+  kLogHID,
+  kLogGraphics,
+  kLogSubsystemCount,
+};
+
+#ifndef LOG_SUBSYSTEM
+#define LOG_SUBSYSTEM kLogKernel
+#endif
+// #@@range_end(log_subsystem)
+
+// #@@range_begin(log_level_max)
+/* 컴파일 시 최대 level: 이보다 상세한 Log는 인자 평가까지 포함해 코드가 생성되지 않음
+Makefile의 LOG_LEVEL_MAX로 변경 (기본 kInfo, USB 조사 시 make LOG_LEVEL_MAX=7) */
+#ifndef LOG_LEVEL_MAX
+#define LOG_LEVEL_MAX 6
+#endif
+constexpr LogLevel kLogLevelMax = static_cast<LogLevel>(LOG_LEVEL_MAX);
+// #@@range_end(log_level_max)
+
+/* 로그 우선순위 임계값 level로 설정 (전체 / 분류 하나),
 이후의 Log 호출에서는 설정된 level 이상의 로그만 기록 */
 void SetLogLevel(LogLevel level);
+void SetLogLevel(LogSubsystem subsystem, LogLevel level);
+
+// #@@range_begin(log_macro)
+extern LogLevel log_levels[kLogSubsystemCount];
+
+// 실행 중 임계값 검사 (inline -> 꺼진 level은 logger.cpp 호출도 인자 평가도 없이 비교 1회)
+inline bool LogEnabled(LogSubsystem subsystem, LogLevel level) {
+  return level <= log_levels[subsystem];
+}
+
+/* 임계값을 통과한 경우에만 포맷해서 log ring에 추가 (level은 임계값 검사가 끝난 값)
+기록은 level과 함께 log ring에 쌓일 뿐 -> 콘솔 반영은 DrainLog에서, sink별 level로 골라서 (interrupt handler에서도 호출 가능) */
+int LogMessage(LogLevel level, const char* format, ...)
+  __attribute__((format(printf, 2, 3)));
+
+/* Log(level, format, ...): 이 파일의 분류 (LOG_SUBSYSTEM)로 기록
+LogAs(subsystem, level, ...): 분류를 직접 지정
+level은 상수 (kDebug 등)만 가능: 컴파일 시 최대 level보다 상세하면 if constexpr로 통째로 제거
+LogMessage를 overload하면 (TRB, descriptor 등) Log(level, trb)처럼 같은 방식으로 사용 가능 */
+#define LogAs(subsystem, level, ...) \
+  do { \
+    if constexpr ((level) <= kLogLevelMax) { \
+      if (LogEnabled((subsystem), (level))) { \
+        LogMessage((level), __VA_ARGS__); \
+      } \
+    } \
+  } while (0)
+
+#define Log(level, ...) LogAs(LOG_SUBSYSTEM, level, __VA_ARGS__)
+// #@@range_end(log_macro)
+
+// #@@range_begin(log_limited_macro)
+/* 반복될 수 있는 log (매 이벤트의 실패 등)용: (file, line) site마다 rate limit (log_limit.hpp)
+site의 window 안에서 처음 몇 개만 기록, 나머지는 나중에 "repeated N times" 1줄로
+key는 보통 실패한 곳 (Error::File()/Line()), main loop에서만 사용 */
+bool LogRateCheck(const char* file, int line);
+
+#define LogLimitedAs(subsystem, level, file, line, ...) \
+  do { \
+    if constexpr ((level) <= kLogLevelMax) { \
+      if (LogEnabled((subsystem), (level)) && LogRateCheck((file), (line))) { \
+        LogMessage((level), __VA_ARGS__); \
+      } \
+    } \
+  } while (0)
+
+#define LogLimited(level, file, line, ...) \
+  LogLimitedAs(LOG_SUBSYSTEM, level, file, line, __VA_ARGS__)
+
+// site의 window 길이 (TSC cycle, 보정 후 1초로: SetLogRateWindow(TSCFrequency()))
+void SetLogRateWindow(uint64_t cycles);
+// 지금까지 억제된 log 수 (모든 site)
+uint64_t LogSuppressed();
+// site별 기록 수, 억제 수를 log로 출력
+void LogSuppressionReport();
+// #@@range_end(log_limited_macro)
+
+// #@@range_begin(log_sink)
+// DrainLog이 기록을 내보낼 곳 (bit OR로 여러 곳 지정 가능)
+enum LogSink : unsigned {
+  kLogSinkConsole = 1u << 0,
+  kLogSinkSerial  = 1u << 1, // serial_port가 초기화된 경우에만 출력
+};
+
+// 기본은 콘솔만
+void SetLogSinks(unsigned sinks);
+unsigned LogSinks();
+/* sinks (bit OR)로 내보낼 가장 상세한 level, 기본은 kDebug (기록된 것 모두)
+ex) SetLogSinkLevel(kLogSinkConsole, kWarn): 콘솔에는 경고 이상만, serial에는 전부 */
+void SetLogSinkLevel(unsigned sinks, LogLevel level);
+// #@@range_end(log_sink)
 
-/* 지정된 우선 순위가 임계값 이상이면 기록, 미만이면 폐기 */
-int Log(LogLevel level, const char* format, ...);
+// 포맷이 끝난 문자열 len바이트를 level과 함께 log ring에 추가
+void WriteLog(LogLevel level, const char* s, size_t len);
+/* format을 log ring의 예약한 자리에 바로 포맷 (printk 등, 중간 버퍼 X)
+kMaxRecord보다 긴 출력은 자름 */
+int VWriteLog(LogLevel level, const char* format, va_list ap);
+/* log ring에 쌓인 기록을 순서대로 지정된 sink (콘솔, serial)에 출력 (main loop에서만 호출)
+ring이 가득 차서 버린 기록, 반복이 멈춘 site의 억제 수가 있으면 그것도 출력 */
+void DrainLog();
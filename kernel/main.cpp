@@ -1,22 +1,34 @@
+#include <algorithm>
 #include <cstdint>
 #include <cstddef>
-#include <cstdio>
 #include <numeric>
 #include <vector>
 // #@@range_begin(includes)
 #include "frame_buffer_config.hpp"
 #include "graphics.hpp" // image 관련 코드
+#include "blit.hpp"
+#include "frame_buffer.hpp"
+#include "window.hpp"
+#include "layer.hpp"
 #include "mouse.hpp"
 #include "font.hpp" // font 관련 코드
 #include "console.hpp"
+#include "render_stats.hpp"
+#include "trace.hpp"
 #include "pci.hpp"
 #include "interrupt.hpp"
+#include "ioapic.hpp"
+#include "serial.hpp"
 #include "asmfunc.h"
 #include "queue.hpp"
+#include "message.hpp"
+#include "timer.hpp"
+#include "tsc.hpp"
 
 #include "logger.hpp"
 #include "usb/memory.hpp"
 #include "usb/device.hpp"
+#include "usb/classdriver/keyboard.hpp"
 #include "usb/classdriver/mouse.hpp"
 #include "usb/xhci/xhci.hpp"
 #include "usb/xhci/trb.hpp"
@@ -25,25 +37,38 @@
 const PixelColor kDesktopBGColor{42, 42, 42};
 const PixelColor kDesktopFGColor{0, 240, 0};
 
-char pixel_writer_buf[sizeof(RGBResv8BitPerColorPixelWriter)];
-PixelWriter* pixel_writer;
+// #@@range_begin(screen_buf)
+char screen_buf[sizeof(FrameBuffer)];
+FrameBuffer* screen; // 모든 그리기는 screen의 shadow buffer로, VRAM 반영은 Flush에서
+// #@@range_end(screen_buf)
+
+// #@@range_begin(layer_bufs)
+char layer_manager_buf[sizeof(LayerManager)];
+char desktop_window_buf[sizeof(Window)];
+char console_window_buf[sizeof(Window)];
+char stats_overlay_buf[sizeof(RenderStatsOverlay)];
+RenderStatsOverlay* stats_overlay;
+// #@@range_end(layer_bufs)
 
 // #@@range_begin(console_buf)
 char console_buf[sizeof(Console)];
 Console* console;
 // #@@range_end(console_buf)
 
+// #@@range_begin(serial_port_buf)
+char serial_port_buf[sizeof(SerialPort)];
+SerialPort* serial_port; // COM1이 없으면 nullptr
+// #@@range_end(serial_port_buf)
+
 // #@@range_begin(printk)
+int printk(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
 int printk(const char* format, ...) {
 	va_list ap;
-	int result;
-	char s[1024];
-
 	va_start(ap, format);
-	result = vsprintf(s, format, ap);
+	// level 임계값 X (항상 기록, sink별 level로도 거르지 않도록 kError), 콘솔 반영은 다음 RenderFrame의 DrainLog에서
+	const int result = VWriteLog(kError, format, ap);
 	va_end(ap);
-
-	console->PutString(s);
 	return result;
 }
 // #@@range_end(printk)
@@ -53,10 +78,72 @@ char mouse_cursor_buf[sizeof(MouseCursor)];
 MouseCursor* mouse_cursor;
 
 void MouseObserver(int8_t displacement_x, int8_t displacement_y) {
-	mouse_cursor->MoveRelative({displacement_x, displacement_y});
+	mouse_cursor->MoveRelative({displacement_x, displacement_y}); // 이동량 누적만
 }
 // #@@range_end(mouse_observer)
 
+// #@@range_begin(keyboard_observer)
+// HID keyboard usage ID (HID Usage Tables, Keyboard/Keypad Page)
+const uint8_t kKeyEnd = 0x4d, kKeyPageUp = 0x4b, kKeyPageDown = 0x4e;
+const uint8_t kKeyF7 = 0x40, kKeyF8 = 0x41, kKeyF9 = 0x42, kKeyF10 = 0x43, kKeyF11 = 0x44, kKeyF12 = 0x45;
+
+// 콘솔 scrollback 조작, main_queue 통계, 억제된 log 현황, log 출력 위치, trace 덤프 방법, 그리기 통계 (다시 그린 결과는 다음 RenderFrame에서 화면에 반영)
+void KeyboardObserver(uint8_t keycode) {
+	switch (keycode) {
+	case kKeyPageUp:
+		console->Scroll(console->Rows() - 1); // 1줄 겹치게 1페이지씩
+		break;
+	case kKeyPageDown:
+		console->Scroll(-(console->Rows() - 1));
+		break;
+	case kKeyEnd:
+		console->ScrollToBottom();
+		break;
+	case kKeyF7:
+		LogMessageStats();
+		break;
+	case kKeyF8:
+		LogSuppressionReport();
+		break;
+	case kKeyF9: // log 출력 위치 전환: 콘솔 + serial -> serial만 -> 콘솔만 -> ...
+		if (!serial_port) {
+			break;
+		}
+		if (LogSinks() == (kLogSinkConsole | kLogSinkSerial)) {
+			SetLogSinks(kLogSinkSerial);
+		} else if (LogSinks() == kLogSinkSerial) {
+			SetLogSinks(kLogSinkConsole);
+		} else {
+			SetLogSinks(kLogSinkConsole | kLogSinkSerial);
+		}
+		break;
+	case kKeyF10:
+		LogTraceDumpCommand();
+		break;
+	case kKeyF11:
+		LogRenderStats(); // 기본 log level (kWarn)에서도 보이도록
+		break;
+	case kKeyF12:
+		stats_overlay->Toggle();
+		break;
+	}
+}
+// #@@range_end(keyboard_observer)
+
+// #@@range_begin(render_frame)
+/* log ring에 쌓인 출력을 콘솔로 옮기고, 누적된 콘솔 출력, 마우스 이동을 한 번에 합성하고 VRAM에 반영
+HID report, printk마다 그리지 않고 이벤트 처리가 일단락될 때 1회만 호출 */
+void RenderFrame() {
+	DrainLog();
+	BeginRenderFrame();
+	console->Render();
+	mouse_cursor->Render();
+	stats_overlay->Render(); // 직전 frame의 값
+	screen->Flush();
+	EndRenderFrame();
+}
+// #@@range_end(render_frame)
+
 // #@@range_begin(switch_echi2xhci)
 void SwitchEhci2Xhci(const pci::Device& xhc_dev) {
 	bool intel_ehc_exist = false;
@@ -75,7 +162,7 @@ void SwitchEhci2Xhci(const pci::Device& xhc_dev) {
 	pci::WriteConfReg(xhc_dev, 0xd8, superspeed_ports); // USB3_PSSEN
 	uint32_t ehci2xhci_ports = pci::ReadConfReg(xhc_dev, 0xd4); // XUSB2PRM
 	pci::WriteConfReg(xhc_dev, 0xd0, ehci2xhci_ports); // XUSB2PR
-	Log(kDebug, "SwitchEhci2Xhci: SS = %02, xHCI = %02x\n",
+	LogAs(kLogXHCI, kDebug, "SwitchEhci2Xhci: SS = %02x, xHCI = %02x\n",
 			superspeed_ports, ehci2xhci_ports);
 }
 // #@@range_end(switch_echi2xhci)
@@ -84,13 +171,7 @@ void SwitchEhci2Xhci(const pci::Device& xhc_dev) {
 usb::xhci::Controller* xhc;
 
 // #@@range_begin(queue_message)
-struct Message {
-	enum Type {
-		kInterruptXHCI,
-	} type;
-};
-
-ArrayQueue<Message>* main_queue;
+SPSCQueue<Message>* main_queue; // Message는 message.hpp (timer도 여기로 보냄), 생산자 = interrupt handler
 // #@@range_end(queue_message)
 
 // #@@range_begin(xhci_handler)
@@ -98,46 +179,163 @@ __attribute__((interrupt)) // 컴파일러가 interrupt handler에 필요한 전
 void IntHandlerXHCI(InterruptFrame* frame) {
 	/*while (xhc->PrimaryEventRing()->HasFront()) {
 		if (auto err = ProcessEvent(*xhc)) {
-			Log(kError, "Error while ProcessEvent: %s at %s:%d\n",
+			LogAs(kLogXHCI, kError, "Error while ProcessEvent: %s at %s:%d\n",
 					err.Name(), err.File(), err.Line());
 		}
 	} ProcessEvent 1회 처리시 -> USB로부터 수신한 데이터 해석, MouseObserver 호출, 렌더링 
 	interrupt handler 처리 시간이 길어지면, interrupt 처리 동안 다른 interrupt 못받을 확률이 높아짐
 	동적 메모리 사용하지 않는 Queue(FIFO)를 구현해 해결 */
-	main_queue->Push(Message{Message::kInterruptXHCI});	
+	TRACE("xhci: interrupt, queued %lu", main_queue->Count());
+	// 처리 1회가 event ring 전체를 비움 -> 아직 처리 전인 kInterruptXHCI가 있으면 더 넣지 않음
+	PostCoalescedMessage(Message::kInterruptXHCI);
 	NotifyEndOfInterrupt();
 }
 // #@@range_end(xhci_handler)
 
+// #@@range_begin(serial_handler)
+// FIFO 채우기 (최대 16바이트 out)뿐이므로 main queue를 거치지 않고 handler에서 직접
+__attribute__((interrupt))
+void IntHandlerSerial(InterruptFrame* frame) {
+	serial_port->OnInterrupt();
+	NotifyEndOfInterrupt();
+}
+// #@@range_end(serial_handler)
+
+// #@@range_begin(lapic_timer_handler)
+// tick 진행 + 만료된 timer만 main queue로 (대기 중인 timer 수와 무관하게 짧음)
+__attribute__((interrupt))
+void IntHandlerLAPICTimer(InterruptFrame* frame) {
+	LAPICTimerOnInterrupt();
+	NotifyEndOfInterrupt();
+}
+// #@@range_end(lapic_timer_handler)
+
+// #@@range_begin(timer_values)
+// AddTimer의 value: 만료 Message가 어떤 timer의 것인지
+enum TimerValue {
+	kTimerRenderTick = 1, // 이벤트가 없어도 1초마다 RenderFrame (log 반영, 억제 요약, 그리기 통계)
+};
+
+/* render tick 예약, timer pool이 가득 차서 실패하면 log를 남기고 false
+-> main loop가 깨어날 때마다 (LAPIC timer tick) 다시 시도 (log는 LogLimited로 window당 몇 줄만) */
+bool ArmRenderTick(uint64_t timeout) {
+	if (auto err = AddTimer(timeout, kTimerRenderTick).error) {
+		LogLimited(kError, __FILE__, __LINE__,
+				"failed to add render tick timer: %s\n", err.Name());
+		return false;
+	}
+	return true;
+}
+// #@@range_end(timer_values)
+
+// window 버퍼를 확보할 수 없는 등 화면 구성 자체가 불가능할 때: 화면에 직접 메시지를 쓰고 정지
+void HaltWithMessage(const char* message, const Error& err) {
+	WriteString(screen->Writer(), 0, 0, message, {255, 255, 255});
+	WriteString(screen->Writer(), 0, 16, err.Name(), {255, 255, 255});
+	screen->Flush();
+	while (1) __asm__("hlt");
+}
+
 // #@@range_begin(call_pixel_writer)
 extern "C" void KernelMain(const FrameBufferConfig& frame_buffer_config) {
-	switch (frame_buffer_config.pixel_format) {
-		case kPixelRGBResv8BitPerColor:
-			pixel_writer = new(pixel_writer_buf)
-			RGBResv8BitPerColorPixelWriter{frame_buffer_config};
-			break;
-		case kPixelBGRResv8BitPerColor:
-			pixel_writer = new(pixel_writer_buf)
-			BGRResv8BitPerColorPixelWriter{frame_buffer_config};
-			break;
+	// #@@range_begin(init_screen)
+	// UEFI는 AVX (YMM) 상태를 켜 두지 않음 -> 직접 켜야 BitBlt가 AVX2 kernel을 선택할 수 있음
+	if (CpuSupportsAVX()) {
+		EnableAVX();
 	}
-	
+	InitializeBlit();
+	InitializeTrace(0); // BSP = cpu 0
+	const Error tsc_err = InitializeTSC(); // 이후 모든 구간 측정 (Now, ElapsedNs)의 기준
+	SetLogRateWindow(TSCFrequency()); // 반복 log 억제 window = 1초
+	// 화면보다 먼저: 초기화 도중의 log도 serial로 (송신은 interrupt 설정, sti 이후)
+	serial_port = new(serial_port_buf) SerialPort{SerialPort::kCOM1};
+	if (auto err = serial_port->Initialize()) {
+		serial_port = nullptr; // log는 콘솔에만
+	} else {
+		SetLogSinks(kLogSinkConsole | kLogSinkSerial);
+	}
+	InitializeGraphicsMemory(frame_buffer_config.graphics_memory,
+	                         frame_buffer_config.graphics_memory_size);
+	screen = new(screen_buf) FrameBuffer;
+	if (auto err = screen->Initialize(frame_buffer_config)) {
+		// 화면에 쓸 수단이 없음 (HaltWithMessage도 screen을 씀) -> log ring에만 남기고 정지
+		Log(kError, "failed to initialize screen: %s at %s:%d\n", err.Name(), err.File(), err.Line());
+		while (1) __asm__("hlt");
+	}
+	// #@@range_end(init_screen)
+
 	const int kFrameWidth = frame_buffer_config.horizontal_resolution;
 	const int kFrameHeight = frame_buffer_config.vertical_resolution;
+	const PixelFormat kPixelFormat = frame_buffer_config.pixel_format;
+
+	// #@@range_begin(init_windows)
+	auto desktop_window = new(desktop_window_buf) Window;
+	auto console_window = new(console_window_buf) Window;
+	if (auto err = desktop_window->Initialize(kFrameWidth, kFrameHeight, kPixelFormat)) {
+		HaltWithMessage("failed to allocate desktop window", err);
+	}
+	// 콘솔은 작업 표시줄 위의 화면 전체 (행, 열 수는 Console이 window 크기에서 결정)
+	const int kConsoleWidth = std::min(kFrameWidth, 8 * Console::kMaxColumns);
+	const int kConsoleHeight = std::min(kFrameHeight - 30, 16 * Console::kMaxRows);
+	if (auto err = console_window->Initialize(kConsoleWidth, kConsoleHeight, kPixelFormat)) {
+		HaltWithMessage("failed to allocate console window", err);
+	}
+	// #@@range_end(init_windows)
 
 	// #@@range_begin(draw_desktop)
-	FillRectangle(*pixel_writer,
+	FillRectangle(desktop_window->Writer(),
 		{0, 0},
 		{kFrameWidth, kFrameHeight - 30},
 		kDesktopBGColor);
-	FillRectangle(*pixel_writer,
+	FillRectangle(desktop_window->Writer(),
 		{0, kFrameHeight - 30},
 		{kFrameWidth, 30},
 		{1, 1, 1});
+	FillRectangle(console_window->Writer(),
+		{0, 0},
+		{console_window->Width(), console_window->Height()},
+		kDesktopBGColor);
+
+	// #@@range_begin(init_layers)
+	// 아래에서부터 바탕화면, 콘솔 순서로 겹침 (마우스 커서는 그 위의 sprite)
+	layer_manager = new(layer_manager_buf) LayerManager;
+	layer_manager->SetScreen(screen);
+	Layer* desktop_layer = layer_manager->NewLayer();
+	Layer* console_layer = layer_manager->NewLayer();
+	if (desktop_layer == nullptr || console_layer == nullptr) {
+		HaltWithMessage("failed to allocate layers", MAKE_ERROR(Error::kFull));
+	}
+	auto desktop_layer_id = desktop_layer
+		->SetWindow(desktop_window)
+		.Move({0, 0})
+		.ID();
+	auto console_layer_id = console_layer
+		->SetWindow(console_window)
+		.Move({0, 0})
+		.ID();
+	layer_manager->UpDown(desktop_layer_id, 0);
+	layer_manager->UpDown(console_layer_id, 1);
+	// #@@range_end(init_layers)
 
 	console = new(console_buf) Console{
-		*pixel_writer, kDesktopFGColor, kDesktopBGColor
+		console_window->Writer(), kDesktopFGColor, kDesktopBGColor
 	};
+	console->SetLayerID(console_layer_id);
+	// 그리기 통계 overlay: 오른쪽 위, F12로 표시 전환 (확보 실패 시 표시하지 않을 뿐 계속 진행)
+	stats_overlay = new(stats_overlay_buf) RenderStatsOverlay;
+	if (auto err = stats_overlay->Initialize(kPixelFormat,
+			{kFrameWidth - 8 * RenderStatsOverlay::kColumns - 8, 8})) {
+		LogAs(kLogGraphics, kWarn, "render stats overlay disabled: %s\n", err.Name());
+	}
+
+	layer_manager->Draw({{0, 0}, {kFrameWidth, kFrameHeight}});
+
+	// #@@range_begin(new_mouse_cursor)
+	mouse_cursor = new(mouse_cursor_buf) MouseCursor{screen, {300, 200}};
+	layer_manager->SetSprite(&mouse_cursor->GetSprite());
+	// #@@range_end(new_mouse_cursor)
+	screen->Flush();
+
 	// here KosmOS Ascii
 	printk("Welcome to KosmOS!\n");
 	printk(" /$$   /$$                                    /$$$$$$   /$$$$$$ \n");
@@ -148,30 +346,34 @@ extern "C" void KernelMain(const FrameBufferConfig& frame_buffer_config) {
 	printk("| $$:  $$ | $$  | $$ :____  $$| $$ | $$ | $$| $$  | $$ /$$  : $$\n");
 	printk("| $$ :  $$|  $$$$$$/ /$$$$$$$/| $$ | $$ | $$|  $$$$$$/|  $$$$$$/\n");
 	printk("|__/  :__/ :______/ |_______/ |__/ |__/ |__/ :______/  :______/ \n");
+	RenderFrame();
 	// #@@range_end(draw_desktop)
 	
 	SetLogLevel(kWarn);
 
-	// #@@range_begin(new_mouse_cursor)
-	mouse_cursor = new(mouse_cursor_buf) MouseCursor{
-		pixel_writer, kDesktopBGColor, {300, 200}
-	};
-	// #@@range_end(new_mouse_cursor)
-
 	std::array<Message, 32> main_queue_data;
-	ArrayQueue<Message> main_queue{main_queue_data};
+	SPSCQueue<Message> main_queue{main_queue_data};
 	::main_queue = &main_queue;
   
+	if (tsc_err) {
+		Log(kWarn, "TSC calibration failed (%s): timings are estimates\n", tsc_err.Name());
+	}
+	if (!TSCInvariant()) {
+		Log(kWarn, "TSC is not invariant: timings may drift with CPU frequency\n");
+	}
+	LogAs(kLogKernel, kInfo, "TSC: %lu Hz\n", TSCFrequency());
+
+	const uint64_t scan_start = Now();
 	auto err = pci::ScanAllBus();
-	Log(kDebug, "ScanAllBus: %s\n", err.Name());
+	LogAs(kLogPCI, kDebug, "ScanAllBus: %s (%lu us)\n", err.Name(), ElapsedNs(scan_start) / 1000);
 
 	for (int i = 0; i < pci::num_device; ++i) {
 		const auto& dev = pci::devices[i];
 		auto vendor_id = pci::ReadVendorId(dev);
 		auto class_code = pci::ReadClassCode(dev.bus, dev.device, dev.function);
-		Log(kDebug, "%d.%d.%d: vend %04x, class %08x, head %02x\n",
-				dev.bus, dev.device, dev.function,
-				vendor_id, class_code, dev.header_type);
+		LogAs(kLogPCI, kDebug, "%d.%d.%d: vend %04x, class %02x%02x%02x, head %02x\n",
+				dev.bus, dev.device, dev.function, vendor_id,
+				class_code.base, class_code.sub, class_code.interface, dev.header_type);
 	}
 
 	// #@@range_begin(find_xhc)
@@ -190,7 +392,7 @@ extern "C" void KernelMain(const FrameBufferConfig& frame_buffer_config) {
 	}
 
 	if (xhc_dev) {
-		Log(kInfo, "xHC has been found: %d.%d.%d\n",
+		LogAs(kLogXHCI, kInfo, "xHC has been found: %d.%d.%d\n",
 				xhc_dev->bus, xhc_dev->device, xhc_dev->function);
 	}
 	// #@@range_end(find_xhc)
@@ -200,6 +402,10 @@ extern "C" void KernelMain(const FrameBufferConfig& frame_buffer_config) {
 	// InterruptVector::kXHCI : 0x40 정의
 	SetIDTEntry(idt[InterruptVector::kXHCI], MakeIDTAttr(DescriptorType::kInterruptGate, 0),
 							reinterpret_cast<uint64_t>(IntHandlerXHCI), cs); // 현재 code segment 값 지정
+	SetIDTEntry(idt[InterruptVector::kSerial], MakeIDTAttr(DescriptorType::kInterruptGate, 0),
+							reinterpret_cast<uint64_t>(IntHandlerSerial), cs);
+	SetIDTEntry(idt[InterruptVector::kLAPICTimer], MakeIDTAttr(DescriptorType::kInterruptGate, 0),
+							reinterpret_cast<uint64_t>(IntHandlerLAPICTimer), cs);
 	LoadIDT(sizeof(idt) - 1, reinterpret_cast<uintptr_t>(&idt[0]));
 	// #@@range_end(load_idt)
 
@@ -212,6 +418,23 @@ extern "C" void KernelMain(const FrameBufferConfig& frame_buffer_config) {
 			pci::MSIDeliveryMode::kFixed,
 			InterruptVector::kXHCI, 0); // 지정한 interrupt 발생시키라는 설정
 	// #@@range_end(configure_msi)
+
+	// #@@range_begin(route_serial_irq)
+	// COM1은 PCI 장치가 아님 -> MSI 대신 I/O APIC으로 IRQ 4를 BSP에 전달
+	ioapic::DisableLegacyPIC();
+	if (serial_port) {
+		ioapic::RouteISAIRQ(SerialPort::kCOM1IRQ, InterruptVector::kSerial, bsp_local_apic_id);
+		serial_port->StartTransmit(); // 여기까지 쌓인 log (전달은 sti 이후)
+	} else {
+		Log(kWarn, "serial port (COM1) not found, logging to console only\n");
+	}
+	// #@@range_end(route_serial_irq)
+
+	// #@@range_begin(init_lapic_timer)
+	// 만료는 main_queue로 (tick interrupt 전달은 sti 이후)
+	InitializeLAPICTimer();
+	LogAs(kLogKernel, kInfo, "LAPIC timer: %lu Hz, %d ticks/s\n", LAPICTimerFrequency(), kTimerFrequency);
+	// #@@range_end(init_lapic_timer)
 	
 	// #@@range_begin(read_bar)
 	/* xHCI Spec상, xHC를 제어하는 레지스터: MMIO -> memory address space 어딘가에 register 존재
@@ -220,14 +443,15 @@ extern "C" void KernelMain(const FrameBufferConfig& frame_buffer_config) {
 	ReadBar: 지정된 BAR, 후속 BAR 읽어 결합한 주소 반환 ->
 	최종적으로 xhc_bar = xHC의 MMIO 지정 64bit address 설정 */
 	const WithError<uint64_t> xhc_bar = pci::ReadBar(*xhc_dev, 0);
-	Log(kDebug, "ReadBar: %s\n", xhc_bar.error.Name());
+	LogAs(kLogXHCI, kDebug, "ReadBar: %s\n", xhc_bar.error.Name());
 	// 하위 4bit 플래그 마스크 -> get MMIO Base address
 	const uint64_t xhc_mmio_base = xhc_bar.value & ~static_cast<uint64_t>(0xf);
-	Log(kDebug, "xHC mmio_base = %08lx\n", xhc_mmio_base);
+	LogAs(kLogXHCI, kDebug, "xHC mmio_base = %08lx\n", xhc_mmio_base);
 	// #@@range_end(read_bar)
 
 	// #@@range_begin(init_xhc)
 	// BAR0 값을 이용해 xHC 초기화 (xHC reset, 동작에 필요한 설정)
+	const uint64_t xhc_init_start = Now();
 	usb::xhci::Controller xhc{xhc_mmio_base};
 
 	if (0x8086 == pci::ReadVendorId(*xhc_dev)) {
@@ -236,10 +460,11 @@ extern "C" void KernelMain(const FrameBufferConfig& frame_buffer_config) {
 	}
 	{
 		auto err = xhc.Initialize();
-		Log(kDebug, "xhc.Initialize: %s\n", err.Name());
+		LogAs(kLogXHCI, kDebug, "xhc.Initialize: %s (%lu us)\n", err.Name(), ElapsedNs(xhc_init_start) / 1000);
 	}
 
-	Log(kInfo, "xHC starting\n");
+	LogAs(kLogXHCI, kInfo, "xHC starting\n");
+	RenderFrame(); // 초기화 도중 멈추는 경우에도 여기까지의 로그는 보이도록
 	xhc.Run(); // xHC 동작 (PC에 연결된 USB의 기기 인식 순차적으로 진행)
 	// #@@range_end(init_xhc)
 
@@ -248,46 +473,88 @@ extern "C" void KernelMain(const FrameBufferConfig& frame_buffer_config) {
 	
 	// #@@range_begin(configure_port)
 	usb::HIDMouseDriver::default_observer = MouseObserver;
+	usb::HIDKeyboardDriver::default_observer = KeyboardObserver;
 
 	for (int i = 1; i <= xhc.MaxPorts(); ++i) {
 		auto port = xhc.PortAt(i);
-		Log(kDebug, "Port %d: IsConnected=%d\n", i, port.IsConnected());
+		LogAs(kLogXHCI, kDebug, "Port %d: IsConnected=%d\n", i, port.IsConnected());
 
 		if (port.IsConnected()) {
 			if (auto err = ConfigurePort(xhc, port)) {
-				Log(kError, "failed to configure port: %s at %s:%d\n",
+				LogAs(kLogXHCI, kError, "failed to configure port: %s at %s:%d\n",
 						err.Name(), err.File(), err.Line());
 				continue;
 			}
 		}
 	}
 	// #@@range_end(configure_port)
+
+	bool render_tick_armed = ArmRenderTick(CurrentTick() + kTimerFrequency);
+	CheckTSCDrift(kTimerFrequency / 5); // 200ms
 	
 	// #@@range_begin(event_loop)
+	std::array<Message, 32> messages; // 한 번에 꺼내는 묶음 (queue 크기만큼)
+	uint64_t reported_drops = 0; // log로 알린 main_queue의 버림 수
+	bool render_pending = true; // 마지막 RenderFrame 이후 처리한 Message가 있음 (처음은 초기화 도중의 log)
 	while (true) {
 		// #@@range_begin(get_front_message)
-		__asm__("cli"); // CPU interrupt flag to 0 // 외부 interrupt 차단 (race condition 차단 효과 / 완벽 X)
-		if (main_queue.Count() == 0) {
-			__asm__("sti\n\thlt");
+		// cli X: handler는 write 위치, main loop는 read 위치만 갱신 (SPSCQueue)
+		const size_t count = main_queue.PopBatch(messages.data(), messages.size());
+		if (count == 0) {
+			if (!render_tick_armed) {
+				render_tick_armed = ArmRenderTick(CurrentTick() + kTimerFrequency);
+			}
+			/* queue를 다 비운 시점 = 이번 이벤트 묶음 처리 완료 -> 누적된 변경을 1회만 렌더링
+			Message 없이 깨어난 경우 (timer tick 등)는 그리지 않음 -> 평소에는 render tick의 1초 1회 */
+			if (render_pending) {
+				RenderFrame();
+				render_pending = false;
+			}
+			/* 확인과 hlt 사이에 온 interrupt로 깨어나지 못하는 일이 없도록 이 둘만 cli로 묶음
+			(sti 직후 1명령은 interrupt를 받지 않음 -> sti; hlt는 끊기지 않음) */
+			__asm__("cli");
+			if (main_queue.Count() == 0) {
+				__asm__("sti\n\thlt");
+			} else {
+				__asm__("sti");
+			}
 			continue;
 		}
-
-		Message msg = main_queue.Front();
-		main_queue.Pop();
-		__asm__("sti"); // CPU interrupt flag to 1 // 외부 interrupt 승인
+		render_pending = true;
 		// #@@range_end(get_front_message)
 
-		switch (msg.type) {
-		case Message::kInterruptXHCI:
-			while (xhc.PrimaryEventRing()->HasFront()) {
-				if (auto err = ProcessEvent(xhc)) {
-					Log(kError, "Error while ProcessEvent: %s at %s:%d\n",
-							err.Name(), err.File(), err.Line());
+		for (size_t i = 0; i < count; ++i) {
+			const Message& msg = messages[i];
+			AcknowledgeMessage(msg.type);
+			switch (msg.type) {
+			case Message::kInterruptXHCI: {
+				const uint64_t start = Now();
+				while (xhc.PrimaryEventRing()->HasFront()) {
+					if (auto err = ProcessEvent(xhc)) {
+						// 매 이벤트 실패해도 실패한 곳마다 window당 몇 줄만 (나머지는 "repeated N times")
+						LogLimitedAs(kLogXHCI, kError, err.File(), err.Line(),
+								"Error while ProcessEvent: %s at %s:%d\n",
+								err.Name(), err.File(), err.Line());
+					}
 				}
+				TRACE("xhci: events handled in %lu cycles", Elapsed(start));
+				break;
+			}
+			case Message::kTimerTimeout:
+				if (msg.arg.timer.value == kTimerRenderTick) {
+					// 다음 tick 예약 (그리기는 queue가 비면 루프 위쪽에서)
+					render_tick_armed = ArmRenderTick(msg.arg.timer.timeout + kTimerFrequency);
+					// queue가 가득 차서 잃은 wakeup이 있으면 1초에 1번만 알림 (자세한 내용은 F7)
+					const uint64_t drops = MessagesDropped();
+					if (drops != reported_drops) {
+						Log(kWarn, "main_queue: %lu messages dropped\n", drops - reported_drops);
+						reported_drops = drops;
+					}
+				}
+				break;
+			default:
+				Log(kError, "Unknown message type: %d\n", msg.type);
 			}
-			break;
-		default:
-			Log(kError, "Unknown message type: %d\n", msg.type);
 		}
 	}
 	// #@@range_end(event_loop)
@@ -295,4 +562,4 @@ extern "C" void KernelMain(const FrameBufferConfig& frame_buffer_config) {
 
 extern "C" void __cxa_pure_virtual() {
 	while (1) __asm__("hlt");
-}
\ No newline at end of file
+}
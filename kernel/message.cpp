@@ -0,0 +1,76 @@
+#include "message.hpp"
+
+#include <array>
+#include <atomic>
+
+#include "logger.hpp"
+#include "queue.hpp"
+
+extern SPSCQueue<Message>* main_queue;
+
+namespace {
+	std::atomic<bool> pending[Message::kLastOfType]; // 종류별: queue에 있고 아직 처리 시작 전
+	MessageCounters counters[Message::kLastOfType]; // interrupt handler만 갱신
+
+	constexpr std::array type_names{
+		"kInterruptXHCI",
+		"kTimerTimeout",
+	};
+	static_assert(Message::kLastOfType == type_names.size());
+
+	const char* TypeName(int type) {
+		return type_names[type];
+	}
+}
+
+// #@@range_begin(post_message)
+Error PostMessage(const Message& msg) {
+	MessageCounters& c = counters[msg.type];
+	if (auto err = main_queue->Push(msg)) {
+		++c.dropped;
+		return err;
+	}
+	++c.pushed;
+	return MAKE_ERROR(Error::kSuccess);
+}
+
+Error PostCoalescedMessage(Message::Type type) {
+	if (pending[type].exchange(true)) {
+		++counters[type].coalesced; // 대기 중인 Message의 처리가 이번 일도 처리
+		return MAKE_ERROR(Error::kSuccess);
+	}
+	Message msg{};
+	msg.type = type;
+	auto err = PostMessage(msg);
+	if (err) {
+		pending[type].store(false); // queue에 없음 -> 다음 번에 다시 시도
+	}
+	return err;
+}
+
+void AcknowledgeMessage(Message::Type type) {
+	// 처리 (xHC의 event ring 읽기 등)보다 먼저: 그 뒤에 생긴 일은 새 Message로
+	pending[type].store(false);
+}
+// #@@range_end(post_message)
+
+const MessageCounters& MessageStats(Message::Type type) {
+	return counters[type];
+}
+
+uint64_t MessagesDropped() {
+	uint64_t dropped = 0;
+	for (const auto& c : counters) {
+		dropped += c.dropped;
+	}
+	return dropped;
+}
+
+void LogMessageStats() {
+	Log(kWarn, "main_queue: %lu queued now\n", main_queue->Count());
+	for (int type = 0; type < Message::kLastOfType; ++type) {
+		const MessageCounters& c = counters[type];
+		Log(kWarn, "  %s: pushed %lu, coalesced %lu, dropped %lu\n",
+		    TypeName(type), c.pushed, c.coalesced, c.dropped);
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "error.hpp"
+
+// #@@range_begin(message)
+// interrupt handler, timer -> main loop으로 보내는 일 (main_queue)
+struct Message {
+	enum Type {
+		kInterruptXHCI,
+		kTimerTimeout,
+		kLastOfType, // 종류 수 (종류별 counter용, Message로 보내지 않음)
+	} type;
+
+	union {
+		struct {
+			uint64_t timeout; // 만료된 tick
+			int value; // AddTimer에 넘긴 값 (어떤 timer인지)
+		} timer;
+	} arg;
+};
+// #@@range_end(message)
+
+// #@@range_begin(post_message)
+/* main_queue에 넣기 (생산자 = interrupt handler에서만 호출)
+PostMessage: 그대로 넣음 (timer 만료처럼 Message마다 내용이 다른 것)
+PostCoalescedMessage: 그 종류가 아직 처리되지 않고 대기 중이면 넣지 않음 (coalesce)
+	-> xHCI interrupt처럼 처리 1회가 그때까지 쌓인 일을 모두 처리하는 것 (queue 자리 낭비 X)
+queue가 가득 차면 kFull (버린 수는 종류별 counter에) */
+Error PostMessage(const Message& msg);
+Error PostCoalescedMessage(Message::Type type);
+// main loop가 Message 처리를 시작할 때 호출: 이후 도착한 같은 종류는 다시 queue로
+void AcknowledgeMessage(Message::Type type);
+
+// 종류별 누계 (부팅 후)
+struct MessageCounters {
+	uint64_t pushed; // queue에 넣음
+	uint64_t coalesced; // 이미 대기 중이라 넣지 않음 (wakeup은 잃지 않음)
+	uint64_t dropped; // queue가 가득 차서 넣지 못함 (wakeup 손실, timer 만료는 다음 tick에 다시 시도하므로 시도마다 셈)
+};
+const MessageCounters& MessageStats(Message::Type type);
+uint64_t MessagesDropped(); // 모든 종류의 dropped 합
+// 종류별 counter를 log로 출력 (kWarn)
+void LogMessageStats();
+// #@@range_end(post_message)
@@ -1,10 +1,9 @@
 #include "mouse.hpp"
 
+#include <algorithm>
 #include "graphics.hpp"
 
 namespace {
-	const int kMouseCursorWidth = 15;
-	const int kMouseCursorHeight = 24;
 	const char mouse_cursor_shape[kMouseCursorHeight][kMouseCursorWidth + 1] = {
 		"@              ",
 		"@@             ",
@@ -32,42 +31,46 @@ namespace {
 		"         @@@   ",
 	};
 
-	void DrawMouseCursor(PixelWriter* pixel_writer, Vector2D<int> position) {
-		for (int dy = 0; dy < kMouseCursorHeight; ++dy) {
-			for (int dx = 0; dx < kMouseCursorWidth; ++dx) {
-				if (mouse_cursor_shape[dy][dx] == '@') {
-					pixel_writer->Write(position.x + dx, position.y + dy, {0, 0, 0});
-				} else if (mouse_cursor_shape[dy][dx] == '.') {
-					pixel_writer->Write(position.x + dx, position.y + dy, {255, 255, 255});
-				}
-			}
-		}
-	}
+	static_assert(kMouseCursorWidth <= Sprite::kMaxWidth &&
+	              kMouseCursorHeight <= Sprite::kMaxHeight);
+}
 
-	void EraseMouseCursor(PixelWriter* pixel_writer, Vector2D<int> position,
-												PixelColor erase_color) {
-		for (int dy = 0; dy < kMouseCursorHeight; ++dy) {
-			for (int dx = 0; dx < kMouseCursorWidth; ++dx) {
-				if (mouse_cursor_shape[dy][dx] != ' ') {
-					pixel_writer->Write(position.x + dx, position.y + dy, erase_color);
-				}
+// #@@range_begin(mouse_class)
+MouseCursor::MouseCursor(FrameBuffer* screen, Vector2D<int> initial_position)
+		: screen_{screen} {
+	// 모양 해석은 여기서 1회만: '@' 검정, '.' 흰색 (alpha 255), ' ' 비표시 (alpha 0)
+	const PixelFormat format = screen_->Config().pixel_format;
+	const uint32_t kOpaque = 0xffu << 24;
+	const uint32_t black = EncodePixel(format, {0, 0, 0}) | kOpaque;
+	const uint32_t white = EncodePixel(format, {255, 255, 255}) | kOpaque;
+	uint32_t pixels[kMouseCursorWidth * kMouseCursorHeight] = {};
+	for (int dy = 0; dy < kMouseCursorHeight; ++dy) {
+		for (int dx = 0; dx < kMouseCursorWidth; ++dx) {
+			const char c = mouse_cursor_shape[dy][dx];
+			if (c != ' ') {
+				pixels[kMouseCursorWidth * dy + dx] = c == '@' ? black : white;
 			}
 		}
 	}
+	sprite_.SetImage(kMouseCursorWidth, kMouseCursorHeight, pixels);
+	sprite_.MoveTo(*screen_, initial_position);
 }
 
-// #@@range_begin(mouse_class)
-MouseCursor::MouseCursor(PixelWriter* writer, PixelColor erase_color,
-												 Vector2D<int> initial_position)
-		: pixel_writer_{writer},
-			erase_color_{erase_color},
-			position_{initial_position} {
-	DrawMouseCursor(pixel_writer_, position_);
+void MouseCursor::MoveRelative(Vector2D<int> displacement) {
+	pending_displacement_ += displacement;
 }
 
-void MouseCursor::MoveRelative(Vector2D<int> displacement) {
-	EraseMouseCursor(pixel_writer_, position_, erase_color_);
-	position_ += displacement;
-	DrawMouseCursor(pixel_writer_, position_);
+void MouseCursor::Render() {
+	if (pending_displacement_.x == 0 && pending_displacement_.y == 0) {
+		return;
+	}
+	auto pos = sprite_.Position();
+	pos += pending_displacement_;
+	pending_displacement_ = {0, 0};
+	// 커서 끝 (왼쪽 위)이 화면 안에 남도록 (그리기 자체는 writer의 clip이 잘라냄)
+	const FrameBufferConfig& config = screen_->Config();
+	pos.x = std::max(0, std::min(pos.x, static_cast<int>(config.horizontal_resolution) - 1));
+	pos.y = std::max(0, std::min(pos.y, static_cast<int>(config.vertical_resolution) - 1));
+	sprite_.MoveTo(*screen_, pos);
 }
 // #@@range_end(mouse_class)
@@ -1,16 +1,29 @@
 #pragma once
 
 // #@@range_begin(mouse_class)
+#include "frame_buffer.hpp"
 #include "graphics.hpp"
+#include "sprite.hpp"
 
+const int kMouseCursorWidth = 15;
+const int kMouseCursorHeight = 24;
+
+/* 커서 모양은 생성 시 1회만 화면 포맷의 sprite (픽셀 + alpha)로 변환
+이동은 save-under 복원 + 새 위치 저장, 그리기 -> 아래 layer는 다시 합성하지 않음
+HID report마다 그리지 않고 이동량만 누적, Render에서 1회만 반영 */
 class MouseCursor {
  public:
-	MouseCursor(PixelWriter* writer, PixelColor erase_color, Vector2D<int> initial_position);
+	// 생성 시점의 screen 내용 위에 표시 (layer 합성이 끝난 뒤 생성)
+	MouseCursor(FrameBuffer* screen, Vector2D<int> initial_position);
+	Sprite& GetSprite() { return sprite_; }
+	// 이동량 누적만 (그리기 X)
 	void MoveRelative(Vector2D<int> displacement);
+	// 누적된 이동을 화면에 반영
+	void Render();
 
  private:
-	PixelWriter* pixel_writer_ = nullptr;
-	PixelColor erase_color_;
-	Vector2D<int> position_;
+	FrameBuffer* screen_;
+	Sprite sprite_;
+	Vector2D<int> pending_displacement_{0, 0};
 };
 // #@@range_end(mouse_class)
@@ -0,0 +1,34 @@
+#include "pit.hpp"
+
+#include "asmfunc.h"
+
+namespace {
+	const uint16_t kChannel2 = 0x42;
+	const uint16_t kCommand = 0x43;
+	const uint16_t kGatePort = 0x61;
+	const uint8_t kGateOn = 1u << 0, kSpeakerOn = 1u << 1, kOut2 = 1u << 5;
+	const uint8_t kChannel2Mode0 = 0xb0; // channel 2, 하위 -> 상위 바이트, mode 0 (terminal count에서 출력 1)
+
+	uint8_t saved_gate; // Arm 전의 port 0x61
+}
+
+namespace pit {
+	void Arm(uint32_t ms) {
+		const uint16_t count = kFrequency * (ms < kMaxMs ? ms : kMaxMs) / 1000;
+		saved_gate = IoIn8(kGatePort);
+		IoOut8(kGatePort, saved_gate & ~(kGateOn | kSpeakerOn)); // 설정하는 동안 channel 2 정지
+		IoOut8(kCommand, kChannel2Mode0);
+		IoOut8(kChannel2, count & 0xff);
+		IoOut8(kChannel2, count >> 8);
+	}
+
+	void Start() {
+		IoOut8(kGatePort, (saved_gate & ~kSpeakerOn) | kGateOn);
+	}
+
+	void Wait() {
+		while ((IoIn8(kGatePort) & kOut2) == 0) {
+		}
+		IoOut8(kGatePort, saved_gate);
+	}
+}
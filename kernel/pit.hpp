@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+// #@@range_begin(pit)
+/* 8254 PIT channel 2: 다른 시계 (Local APIC timer, TSC)의 보정용 기준 (1.193182MHz)
+port 0x61의 bit 0 (gate)으로 세기 시작, bit 5로 끝났는지 확인 -> interrupt X, 폴링만
+Arm -> (측정할 시계 읽기) -> Start -> Wait -> (다시 읽기) 순서로 사용 */
+namespace pit {
+	const uint32_t kFrequency = 1193182;
+	const uint32_t kMaxMs = 54; // 16bit count의 한계
+
+	// ms (kMaxMs 이하) 동안 세도록 설정 (아직 세지 않음, PC speaker는 끔)
+	void Arm(uint32_t ms);
+	// 세기 시작
+	void Start();
+	// 다 셀 때까지 대기, port 0x61을 Arm 전 상태로
+	void Wait();
+}
+// #@@range_end(pit)
@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <array>
+#include <atomic>
 
 #include "error.hpp"
 
@@ -91,3 +92,84 @@ const T& ArrayQueue<T>::Front() const {
 	return data_[read_pos_];
 }
 // #@@range_end(front)
+
+// #@@range_begin(spsc_class)
+/* ArrayQueue의 lock-free 판: 생산자 1곳, 소비자 1곳 (interrupt handler -> main loop)
+양쪽 모두 cli 없이 사용 가능: 생산자는 write_pos_, 소비자는 read_pos_만 갱신 (release)하고 상대 것은 acquire로 읽음
+위치는 계속 증가하는 값 (칸 = 위치 & (capacity - 1)) -> capacity는 2의 거듭제곱
+같은 CPU의 interrupt handler끼리는 겹치지 않으므로 (interrupt gate) handler가 여러 개여도 생산자 1곳 */
+template <typename T>
+class SPSCQueue {
+ public:
+	template <size_t N>
+	SPSCQueue(std::array<T, N>& buf);
+	Error Push(const T& value);
+	// values의 앞에서부터 자리가 있는 만큼 추가, 추가한 수 반환
+	size_t PushBatch(const T* values, size_t count);
+	// 맨 앞 1개를 꺼내 value로 (비었으면 kEmpty)
+	Error Pop(T& value);
+	// 최대 max개를 꺼내 values로, 꺼낸 수 반환 (소비자가 한 번에 비우기용)
+	size_t PopBatch(T* values, size_t max);
+	size_t Count() const;
+	size_t Capacity() const;
+
+ private:
+	T* data_;
+	const size_t mask_;
+	std::atomic<size_t> read_pos_{0}; // 소비자만 갱신
+	std::atomic<size_t> write_pos_{0}; // 생산자만 갱신
+};
+// #@@range_end(spsc_class)
+
+// #@@range_begin(spsc_impl)
+template <typename T>
+template <size_t N>
+SPSCQueue<T>::SPSCQueue(std::array<T, N>& buf) : data_{buf.data()}, mask_{N - 1} {
+	static_assert(N != 0 && (N & (N - 1)) == 0, "SPSCQueue의 크기는 2의 거듭제곱");
+}
+
+template <typename T>
+Error SPSCQueue<T>::Push(const T& value) {
+	return PushBatch(&value, 1) == 1 ? MAKE_ERROR(Error::kSuccess) : MAKE_ERROR(Error::kFull);
+}
+
+template <typename T>
+size_t SPSCQueue<T>::PushBatch(const T* values, size_t count) {
+	const size_t write_pos = write_pos_.load(std::memory_order_relaxed);
+	// 소비자가 다 읽은 칸만 덮어씀 (acquire: 읽기가 끝난 뒤의 read_pos_)
+	const size_t space = Capacity() - (write_pos - read_pos_.load(std::memory_order_acquire));
+	const size_t n = count < space ? count : space;
+	for (size_t i = 0; i < n; ++i) {
+		data_[(write_pos + i) & mask_] = values[i];
+	}
+	write_pos_.store(write_pos + n, std::memory_order_release); // 내용을 다 쓴 뒤 공개
+	return n;
+}
+
+template <typename T>
+Error SPSCQueue<T>::Pop(T& value) {
+	return PopBatch(&value, 1) == 1 ? MAKE_ERROR(Error::kSuccess) : MAKE_ERROR(Error::kEmpty);
+}
+
+template <typename T>
+size_t SPSCQueue<T>::PopBatch(T* values, size_t max) {
+	const size_t read_pos = read_pos_.load(std::memory_order_relaxed);
+	const size_t available = write_pos_.load(std::memory_order_acquire) - read_pos;
+	const size_t n = max < available ? max : available;
+	for (size_t i = 0; i < n; ++i) {
+		values[i] = data_[(read_pos + i) & mask_];
+	}
+	read_pos_.store(read_pos + n, std::memory_order_release); // 다 읽은 뒤 칸 반환
+	return n;
+}
+
+template <typename T>
+size_t SPSCQueue<T>::Count() const {
+	return write_pos_.load(std::memory_order_acquire) - read_pos_.load(std::memory_order_acquire);
+}
+
+template <typename T>
+size_t SPSCQueue<T>::Capacity() const {
+	return mask_ + 1;
+}
+// #@@range_end(spsc_impl)
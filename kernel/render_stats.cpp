@@ -0,0 +1,118 @@
+#define LOG_SUBSYSTEM kLogGraphics
+
+#include "render_stats.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "font.hpp"
+#include "format.hpp"
+#include "layer.hpp"
+#include "logger.hpp"
+#include "tsc.hpp"
+
+namespace {
+	RenderCounters frame_start_counters; // 직전 frame 종료 시점의 render_counters
+	RenderFrameStats last_frame;
+	uint64_t frame_start_cycles, total_cycles, max_cycles, frame_count;
+
+	RenderCounters Difference(const RenderCounters& a, const RenderCounters& b) {
+		return {a.pixels_written - b.pixels_written, a.composite_pixels - b.composite_pixels,
+		        a.flush_bytes - b.flush_bytes, a.glyphs_drawn - b.glyphs_drawn,
+		        a.glyphs_rasterized - b.glyphs_rasterized};
+	}
+
+	const PixelColor kOverlayBGColor{0, 0, 0};
+	const PixelColor kOverlayFGColor{255, 255, 0};
+}
+
+// #@@range_begin(render_frame_stats)
+void BeginRenderFrame() {
+	frame_start_cycles = Now();
+}
+
+void EndRenderFrame() {
+	last_frame.cycles = Elapsed(frame_start_cycles);
+	last_frame.counters = Difference(render_counters, frame_start_counters);
+	frame_start_counters = render_counters;
+	total_cycles += last_frame.cycles;
+	max_cycles = std::max(max_cycles, last_frame.cycles);
+	++frame_count;
+}
+
+const RenderFrameStats& LastRenderFrame() {
+	return last_frame;
+}
+
+void LogRenderStats() {
+	const RenderCounters& total = render_counters;
+	const RenderCounters& last = last_frame.counters;
+	const uint64_t frames = frame_count ? frame_count : 1;
+	Log(kWarn, "render: %lu frames, avg %lu cycles (%lu us), max %lu cycles (%lu us)\n",
+	    frame_count, total_cycles / frames, CyclesToNs(total_cycles / frames) / 1000,
+	    max_cycles, CyclesToNs(max_cycles) / 1000);
+	Log(kWarn, "  total: pixels %lu, composite %lu, flush %lu B, glyphs %lu (+%lu rasterized)\n",
+	    total.pixels_written, total.composite_pixels, total.flush_bytes,
+	    total.glyphs_drawn, total.glyphs_rasterized);
+	Log(kWarn, "  last:  pixels %lu, composite %lu, flush %lu B, glyphs %lu (+%lu rasterized), %lu cycles\n",
+	    last.pixels_written, last.composite_pixels, last.flush_bytes,
+	    last.glyphs_drawn, last.glyphs_rasterized, last_frame.cycles);
+}
+// #@@range_end(render_frame_stats)
+
+// #@@range_begin(render_stats_overlay)
+Error RenderStatsOverlay::Initialize(PixelFormat format, Vector2D<int> pos) {
+	if (auto err = window_.Initialize(8 * kColumns, 16 * kRows, format)) {
+		return err;
+	}
+	window_.Writer().FillRectangle({0, 0}, {window_.Width(), window_.Height()}, kOverlayBGColor);
+	pos_ = pos;
+	Layer* layer = layer_manager->NewLayer();
+	if (layer == nullptr) {
+		return MAKE_ERROR(Error::kFull);
+	}
+	layer_id_ = layer->SetWindow(&window_).Move(pos_).ID();
+	return MAKE_ERROR(Error::kSuccess);
+}
+
+void RenderStatsOverlay::Toggle() {
+	if (layer_id_ == 0) {
+		return;
+	}
+	visible_ = !visible_;
+	if (visible_) {
+		layer_manager->UpDown(layer_id_, std::numeric_limits<int>::max()); // 최상위 (커서 아래)
+		Render();
+		layer_manager->Draw(layer_id_);
+	} else {
+		layer_manager->Hide(layer_id_);
+		layer_manager->Draw({pos_, {window_.Width(), window_.Height()}}); // 가려져 있던 부분
+	}
+}
+
+void RenderStatsOverlay::Render() {
+	if (!visible_) {
+		return;
+	}
+	const RenderFrameStats& frame = LastRenderFrame();
+	const RenderCounters& c = frame.counters;
+	char text[kRows][kColumns + 1];
+	FormatToBuffer(text[0], sizeof(text[0]), "frame   %10lu us", CyclesToNs(frame.cycles) / 1000);
+	FormatToBuffer(text[1], sizeof(text[1]), "pixels  %10lu", c.pixels_written);
+	FormatToBuffer(text[2], sizeof(text[2]), "compose %10lu", c.composite_pixels);
+	FormatToBuffer(text[3], sizeof(text[3]), "flush   %10lu B", c.flush_bytes);
+	FormatToBuffer(text[4], sizeof(text[4]), "glyphs  %10lu +%lu", c.glyphs_drawn, c.glyphs_rasterized);
+
+	for (int row = 0; row < kRows; ++row) {
+		if (strcmp(text[row], shown_[row]) == 0) {
+			continue;
+		}
+		const Rectangle<int> area{{0, 16 * row}, {window_.Width(), 16}};
+		window_.Writer().FillRectangle(area.pos, area.size, kOverlayBGColor);
+		WriteString(window_.Writer(), 0, area.pos.y, text[row], kOverlayFGColor);
+		memcpy(shown_[row], text[row], sizeof(shown_[row]));
+		layer_manager->Draw(layer_id_, area);
+	}
+}
+// #@@range_end(render_stats_overlay)
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+#include "error.hpp"
+#include "graphics.hpp"
+#include "window.hpp"
+
+// #@@range_begin(render_frame_stats)
+/* RenderFrame 1회분의 카운터 (graphics.hpp의 render_counters 증가분)와 소요 시간
+시간은 TSC cycle (표시할 때 tsc.hpp의 보정값으로 us 환산) */
+struct RenderFrameStats {
+	RenderCounters counters;
+	uint64_t cycles;
+};
+
+// RenderFrame의 처음과 끝에서 호출: 직전 frame 이후 더해진 카운터를 이번 frame분으로 집계
+void BeginRenderFrame();
+void EndRenderFrame();
+const RenderFrameStats& LastRenderFrame();
+
+// 부팅 후 누적, frame당 평균, 가장 오래 걸린 frame, 직전 frame 값을 기록 (kWarn)
+void LogRenderStats();
+// #@@range_end(render_frame_stats)
+
+// #@@range_begin(render_stats_overlay)
+/* 직전 frame의 카운터를 화면 위에 표시하는 layer (처음에는 비표시, Toggle로 전환)
+표시 중에는 내용이 바뀐 행만 다시 그림 -> 그 비용도 다음 frame의 카운터에 포함됨 */
+class RenderStatsOverlay {
+ public:
+	static const int kColumns = 28, kRows = 5;
+
+	// pos: 화면 좌표 (window는 graphics memory에서 확보)
+	Error Initialize(PixelFormat format, Vector2D<int> pos);
+	void Toggle();
+	// RenderFrame에서 Flush 전에 호출
+	void Render();
+
+ private:
+	Window window_;
+	Vector2D<int> pos_{};
+	unsigned int layer_id_ = 0; // 0이면 초기화 실패 -> 표시하지 않음
+	bool visible_ = false;
+	char shown_[kRows][kColumns + 1] = {}; // window에 그려져 있는 내용
+};
+// #@@range_end(render_stats_overlay)
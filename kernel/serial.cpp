@@ -0,0 +1,117 @@
+#include "serial.hpp"
+
+#include "asmfunc.h"
+#include "format.hpp"
+
+namespace {
+	// base로부터의 offset (DLAB = 0)
+	const uint16_t kTHR = 0; // 송신 (쓰기), 수신 (읽기)
+	const uint16_t kIER = 1; // interrupt enable
+	const uint16_t kIIR = 2; // interrupt 식별 (읽기), FIFO 제어 (쓰기)
+	const uint16_t kFCR = 2;
+	const uint16_t kLCR = 3;
+	const uint16_t kMCR = 4;
+	const uint16_t kLSR = 5;
+	// DLAB = 1일 때 0, 1은 분주비
+	const uint16_t kDivisorLow = 0, kDivisorHigh = 1;
+
+	const uint8_t kIERTHREmpty = 1u << 1;
+	const uint8_t kIIRNoPending = 1u << 0;
+	const uint8_t kLCRDLAB = 1u << 7;
+	const uint8_t kLCR8N1 = 0x03;
+	const uint8_t kFCREnableAndClear = 0xc7; // FIFO 사용, 송수신 FIFO 비우기, 수신 threshold 14
+	const uint8_t kMCRLoopback = 0x1e; // loopback + RTS, OUT1, OUT2
+	const uint8_t kMCRNormal = 0x0b; // DTR, RTS, OUT2 (OUT2가 1이어야 interrupt가 밖으로 나감)
+	const uint8_t kLSRTHREmpty = 1u << 5;
+
+	const uint16_t kDivisor = 1; // 115200bps = 115200 / 1
+	const int kFifoBytes = 16;
+}
+
+// #@@range_begin(serial_init)
+Error SerialPort::Initialize() {
+	IoOut8(base_ + kIER, 0);
+	IoOut8(base_ + kLCR, kLCRDLAB);
+	IoOut8(base_ + kDivisorLow, kDivisor & 0xff);
+	IoOut8(base_ + kDivisorHigh, kDivisor >> 8);
+	IoOut8(base_ + kLCR, kLCR8N1);
+	IoOut8(base_ + kFCR, kFCREnableAndClear);
+
+	// 보낸 바이트가 그대로 돌아오는지 확인 (장치가 없으면 0xff 등)
+	IoOut8(base_ + kMCR, kMCRLoopback);
+	IoOut8(base_ + kTHR, 0xae);
+	if (IoIn8(base_ + kTHR) != 0xae) {
+		return MAKE_ERROR(Error::kNoSerialPort);
+	}
+	IoOut8(base_ + kMCR, kMCRNormal);
+	return MAKE_ERROR(Error::kSuccess);
+}
+// #@@range_end(serial_init)
+
+// #@@range_begin(serial_write)
+bool SerialPort::Push(char c) {
+	const uint32_t tail = tail_.load(std::memory_order_relaxed);
+	if (tail - head_.load(std::memory_order_acquire) == kTxBytes) {
+		return false;
+	}
+	tx_[tail % kTxBytes] = c;
+	tail_.store(tail + 1, std::memory_order_release); // handler가 c를 보기 전에 쓰기 완료
+	return true;
+}
+
+void SerialPort::Write(const char* s, size_t len) {
+	if (dropped_ != reported_dropped_) {
+		char notice[64];
+		const int n = FormatToBuffer(notice, sizeof(notice),
+		                             "\r\n[serial: %lu bytes dropped]\r\n", dropped_ - reported_dropped_);
+		const uint32_t used = tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_acquire);
+		if (kTxBytes - used >= static_cast<size_t>(n)) {
+			for (int i = 0; i < n; ++i) {
+				Push(notice[i]);
+			}
+			reported_dropped_ = dropped_;
+		}
+	}
+
+	for (size_t i = 0; i < len; ++i) {
+		if ((s[i] == '\n' && !Push('\r')) || !Push(s[i])) { // 터미널이 raw mode여도 줄 맨 앞으로
+			dropped_ += len - i;
+			break;
+		}
+	}
+	StartTransmit();
+}
+
+void SerialPort::StartTransmit() {
+	/* THR이 비어 있을 때 THR empty interrupt를 켜면 곧바로 interrupt 발생 -> 송신 시작
+	이미 송신 중이면 다음 FIFO가 빌 때 이어서 보냄
+	I/O APIC은 edge 검출: 한 번 끄고 켜서 IRQ 선을 내렸다 올림 (이미 올라가 있던 선은 검출 X)
+	handler가 ring이 비었다고 끈 직후여도, handler는 이 함수 도중에 끼어들 뿐이므로 여기서 다시 켜짐 */
+	IoOut8(base_ + kIER, 0);
+	IoOut8(base_ + kIER, kIERTHREmpty);
+}
+// #@@range_end(serial_write)
+
+// #@@range_begin(serial_interrupt)
+void SerialPort::OnInterrupt() {
+	if (IoIn8(base_ + kIIR) & kIIRNoPending) { // IIR 읽기로 THR empty interrupt는 해제됨
+		return;
+	}
+	FillFifo();
+}
+
+void SerialPort::FillFifo() {
+	if ((IoIn8(base_ + kLSR) & kLSRTHREmpty) == 0) {
+		return;
+	}
+	uint32_t head = head_.load(std::memory_order_relaxed);
+	const uint32_t tail = tail_.load(std::memory_order_acquire);
+	for (int i = 0; i < kFifoBytes && head != tail; ++i, ++head) {
+		IoOut8(base_ + kTHR, tx_[head % kTxBytes]);
+	}
+	head_.store(head, std::memory_order_release); // 보낸 자리는 Write가 재사용 가능
+	if (head == tail) {
+		IoOut8(base_ + kIER, 0); // 보낼 것이 없으면 끔 (켜 두면 FIFO가 빌 때마다 interrupt)
+	}
+}
+// #@@range_end(serial_interrupt)
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "error.hpp"
+
+// #@@range_begin(serial_port)
+/* 16550 UART (COM1 등) 송신 전용 driver: QEMU -serial stdio 등으로 log를 화면 밖에 남기기 위함
+Write는 송신 ring에 복사만 하고 반환, 실제 송신은 THR empty interrupt에서 FIFO (16바이트) 단위로
+	-> 115200bps에서도 쓰는 쪽 (DrainLog)이 UART를 기다리지 않음
+쓰는 쪽은 main loop 하나, 읽는 쪽은 interrupt handler 하나 (single producer, single consumer)
+ring이 가득 차면 넘친 바이트는 버리고, 공간이 생긴 뒤의 Write에서 버린 바이트 수를 먼저 출력 */
+class SerialPort {
+ public:
+	static const uint16_t kCOM1 = 0x3f8; // ISA IRQ 4
+	static const uint8_t kCOM1IRQ = 4;
+	static const size_t kTxBytes = 16 * 1024; // 2의 거듭제곱
+
+	explicit SerialPort(uint16_t base) : base_{base} {}
+	// 115200bps 8N1, FIFO 사용, loopback 검사로 장치가 없으면 kNoSerialPort
+	Error Initialize();
+	// \n은 \r\n으로 바꿔 송신 ring에 추가하고 THR empty interrupt를 켬 (main loop에서만 호출)
+	void Write(const char* s, size_t len);
+	/* THR empty interrupt를 다시 켜서 송신 시작 (Write 안에서도 호출)
+	interrupt 경로 (I/O APIC)가 설정되기 전에 Write한 내용은 설정 후 이것으로 송신 시작 */
+	void StartTransmit();
+	// THR empty interrupt의 handler에서 호출: FIFO를 채우고, 보낼 것이 없으면 interrupt를 끔
+	void OnInterrupt();
+	// ring이 가득 차서 버린 바이트 수
+	uint64_t Dropped() const { return dropped_; }
+
+ private:
+	bool Push(char c);
+	void FillFifo();
+
+	const uint16_t base_;
+	std::atomic<uint32_t> head_{0}; // 다음에 보낼 위치 (interrupt handler만 증가)
+	std::atomic<uint32_t> tail_{0}; // 다음에 쓸 위치 (Write만 증가), 둘 다 감소 X, % kTxBytes로 사용
+	uint64_t dropped_ = 0, reported_dropped_ = 0;
+	char tx_[kTxBytes];
+};
+// #@@range_end(serial_port)
@@ -0,0 +1,78 @@
+#include "sprite.hpp"
+
+namespace {
+	uint32_t* ScreenPixelAt(FrameBuffer& screen, int x, int y) {
+		const FrameBufferConfig& config = screen.Config();
+		return reinterpret_cast<uint32_t*>(config.frame_buffer) +
+			config.pixels_per_scan_line * y + x;
+	}
+}
+
+// #@@range_begin(sprite_set_image)
+void Sprite::SetImage(int width, int height, const uint32_t* pixels) {
+	width_ = width;
+	height_ = height;
+	for (int i = 0; i < width * height; ++i) {
+		pixels_[i] = pixels[i];
+	}
+}
+// #@@range_end(sprite_set_image)
+
+// #@@range_begin(sprite_show_move)
+void Sprite::Show(FrameBuffer& screen) {
+	const Rectangle<int> rect = VisibleArea(screen, Area());
+	SaveUnder(screen, rect);
+	DrawImage(screen, rect);
+	visible_ = true;
+}
+
+void Sprite::MoveTo(FrameBuffer& screen, Vector2D<int> pos) {
+	if (visible_) {
+		RestoreUnder(screen, VisibleArea(screen, Area()));
+	}
+	pos_ = pos;
+	Show(screen);
+}
+
+void Sprite::Refresh(FrameBuffer& screen, const Rectangle<int>& area) {
+	if (!visible_) {
+		return;
+	}
+	const Rectangle<int> rect = VisibleArea(screen, area);
+	SaveUnder(screen, rect);
+	DrawImage(screen, rect);
+}
+// #@@range_end(sprite_show_move)
+
+Rectangle<int> Sprite::VisibleArea(const FrameBuffer& screen, const Rectangle<int>& area) const {
+	const FrameBufferConfig& config = screen.Config();
+	const Rectangle<int> screen_rect{{0, 0}, {static_cast<int>(config.horizontal_resolution),
+	                                          static_cast<int>(config.vertical_resolution)}};
+	return Area() & area & screen_rect;
+}
+
+void Sprite::SaveUnder(FrameBuffer& screen, const Rectangle<int>& rect) {
+	if (IsEmpty(rect)) {
+		return;
+	}
+	const int sx = rect.pos.x - pos_.x, sy = rect.pos.y - pos_.y;
+	for (int dy = 0; dy < rect.size.y; ++dy) {
+		CopySpan32(&save_under_[width_ * (sy + dy) + sx],
+		           ScreenPixelAt(screen, rect.pos.x, rect.pos.y + dy), rect.size.x);
+	}
+}
+
+void Sprite::RestoreUnder(FrameBuffer& screen, const Rectangle<int>& rect) {
+	const ImageView image{save_under_.data(), width_, height_, width_};
+	screen.Writer().BitBlt(rect.pos, image, {{rect.pos.x - pos_.x, rect.pos.y - pos_.y}, rect.size},
+		BlitMode::kOpaque);
+}
+
+// #@@range_begin(sprite_draw_image)
+void Sprite::DrawImage(FrameBuffer& screen, const Rectangle<int>& rect) {
+	// alpha 0인 픽셀은 SIMD kernel이 4/8픽셀 단위로 건너뜀 -> 픽셀마다 분기하지 않음
+	const ImageView image{pixels_.data(), width_, height_, width_};
+	screen.Writer().BitBlt(rect.pos, image, {{rect.pos.x - pos_.x, rect.pos.y - pos_.y}, rect.size},
+		BlitMode::kAlpha);
+}
+// #@@range_end(sprite_draw_image)
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "frame_buffer.hpp"
+#include "graphics.hpp"
+
+/* Sprite: 모든 layer 위에 겹쳐 그리는 작은 이미지 (마우스 커서)
+- 이미지는 화면 포맷의 32bit 픽셀로 미리 변환, 예약 바이트가 alpha (0이면 비표시) -> BitBlt (kAlpha)로 그리기
+- 그리기 전에 아래 픽셀을 save-under 버퍼에 저장, 이동 시 그대로 되돌림
+  -> 이동 비용은 sprite 크기의 복사 3번, 아래 layer 재합성 X */
+class Sprite {
+ public:
+	static const int kMaxWidth = 32;
+	static const int kMaxHeight = 32;
+
+	// pixels: width x height 픽셀 (행 우선, 예약 바이트 = alpha)
+	void SetImage(int width, int height, const uint32_t* pixels);
+
+	Rectangle<int> Area() const { return {pos_, {width_, height_}}; }
+	Vector2D<int> Position() const { return pos_; }
+
+	// 현재 위치에 표시 (아래 픽셀 저장 후 그리기)
+	void Show(FrameBuffer& screen);
+	// 아래 픽셀을 되돌리고 새 위치에 다시 표시
+	void MoveTo(FrameBuffer& screen, Vector2D<int> pos);
+	/* screen의 area가 아래 layer 재합성으로 덮어써진 뒤 호출
+	-> 그 부분의 save-under를 새 픽셀로 갱신하고 sprite를 다시 그림 */
+	void Refresh(FrameBuffer& screen, const Rectangle<int>& area);
+
+ private:
+	int width_ = 0, height_ = 0;
+	Vector2D<int> pos_{0, 0};
+	bool visible_ = false;
+	std::array<uint32_t, kMaxWidth * kMaxHeight> pixels_{};
+	std::array<uint32_t, kMaxWidth * kMaxHeight> save_under_{};
+
+	// 화면 안에 들어오는 부분 (area와의 교집합)
+	Rectangle<int> VisibleArea(const FrameBuffer& screen, const Rectangle<int>& area) const;
+	void SaveUnder(FrameBuffer& screen, const Rectangle<int>& rect);
+	void RestoreUnder(FrameBuffer& screen, const Rectangle<int>& rect);
+	void DrawImage(FrameBuffer& screen, const Rectangle<int>& rect);
+};
@@ -0,0 +1,250 @@
+#include "timer.hpp"
+
+#include <new>
+
+#include "interrupt.hpp"
+#include "message.hpp"
+#include "pit.hpp"
+
+// #@@range_begin(timer_wheel_ctor)
+TimerWheel::TimerWheel(ExpireFunc expire) : expire_{expire} {
+	for (auto& head : heads_) {
+		head = kNil;
+	}
+	for (int i = 0; i < kMaxTimers; ++i) {
+		nodes_[i] = Node{0, 0, 1, kNil, kNil, i + 1 < kMaxTimers ? i + 1 : kNil};
+	}
+}
+// #@@range_end(timer_wheel_ctor)
+
+// #@@range_begin(timer_wheel_add)
+WithError<TimerID> TimerWheel::Add(uint64_t timeout, int value) {
+	if (free_head_ == kNil) {
+		return {kNoTimer, MAKE_ERROR(Error::kFull)};
+	}
+	const int32_t index = free_head_;
+	Node& node = nodes_[index];
+	free_head_ = node.next;
+	node.timeout = timeout;
+	node.value = value;
+	// 이번 tick의 칸은 이미 처리했음 -> 빨라도 다음 tick
+	Place(index, CurrentTick() + 1);
+	++pending_;
+	return {static_cast<TimerID>(index) | static_cast<TimerID>(node.generation) << 16,
+		MAKE_ERROR(Error::kSuccess)};
+}
+
+bool TimerWheel::Cancel(TimerID id) {
+	const int32_t index = id & 0xffff;
+	if (index >= kMaxTimers) {
+		return false;
+	}
+	Node& node = nodes_[index];
+	if (node.slot == kNil || node.generation != id >> 16) {
+		return false; // 이미 만료, 취소됨 (자리가 재사용됐을 수도 있음)
+	}
+	Unlink(index);
+	Free(index);
+	--pending_;
+	return true;
+}
+// #@@range_end(timer_wheel_add)
+
+// #@@range_begin(timer_wheel_tick)
+void TimerWheel::Tick() {
+	const uint64_t tick = tick_.load(std::memory_order_relaxed) + 1;
+	tick_.store(tick, std::memory_order_relaxed);
+
+	// 하위 bit가 모두 0인 단 = 그 단의 칸 하나만큼의 구간이 이번 tick에 시작 -> 하위 단으로 나눠 넣음
+	for (int level = 1; level < kLevels; ++level) {
+		const int shift = kSlotBits * level;
+		if ((tick & ((1ull << shift) - 1)) != 0) {
+			break;
+		}
+		for (int32_t i = Detach(level, (tick >> shift) & (kSlots - 1)); i != kNil;) {
+			const int32_t next = nodes_[i].next;
+			Place(i, tick);
+			i = next;
+		}
+	}
+
+	for (int32_t i = Detach(0, tick & (kSlots - 1)); i != kNil;) {
+		const int32_t next = nodes_[i].next;
+		const Node& node = nodes_[i];
+		if (expire_(node.timeout, node.value)) {
+			Free(i);
+			--pending_;
+		} else {
+			Place(i, tick + 1);
+		}
+		i = next;
+	}
+}
+// #@@range_end(timer_wheel_tick)
+
+// #@@range_begin(timer_wheel_place)
+void TimerWheel::Place(int32_t index, uint64_t earliest) {
+	Node& node = nodes_[index];
+	const uint64_t tick = CurrentTick();
+	const uint64_t at = node.timeout > earliest ? node.timeout : earliest;
+	uint64_t delta = at - tick;
+
+	/* 남은 tick이 64^level 이상 64^(level + 1) 미만인 단
+	-> 그 칸은 tick 이후, at 이전에 시작하는 구간 (cascade가 만료보다 먼저) */
+	int level = 0;
+	while (level < kLevels - 1 && delta >> (kSlotBits * (level + 1)) != 0) {
+		++level;
+	}
+	const uint64_t max_delta = (1ull << (kSlotBits * kLevels)) - 1;
+	if (delta > max_delta) {
+		delta = max_delta; // 최상위 단을 한 바퀴 돈 뒤 다시 배치
+	}
+	const int slot = ((tick + delta) >> (kSlotBits * level)) & (kSlots - 1);
+
+	const int32_t head_index = level * kSlots + slot;
+	const int32_t head = heads_[head_index];
+	node.slot = head_index;
+	node.prev = kNil;
+	node.next = head;
+	if (head != kNil) {
+		nodes_[head].prev = index;
+	}
+	heads_[head_index] = index;
+	occupied_[level] |= 1ull << slot;
+}
+
+void TimerWheel::Unlink(int32_t index) {
+	Node& node = nodes_[index];
+	if (node.prev != kNil) {
+		nodes_[node.prev].next = node.next;
+	} else {
+		heads_[node.slot] = node.next;
+		if (node.next == kNil) {
+			occupied_[node.slot / kSlots] &= ~(1ull << (node.slot % kSlots));
+		}
+	}
+	if (node.next != kNil) {
+		nodes_[node.next].prev = node.prev;
+	}
+}
+
+void TimerWheel::Free(int32_t index) {
+	Node& node = nodes_[index];
+	node.slot = kNil;
+	if (++node.generation == 0) {
+		node.generation = 1; // 0은 kNoTimer용
+	}
+	node.next = free_head_;
+	free_head_ = index;
+}
+
+int32_t TimerWheel::Detach(int level, int slot) {
+	const uint64_t bit = 1ull << slot;
+	if ((occupied_[level] & bit) == 0) {
+		return kNil;
+	}
+	occupied_[level] &= ~bit;
+	const int32_t head = heads_[level * kSlots + slot];
+	heads_[level * kSlots + slot] = kNil;
+	return head;
+}
+// #@@range_end(timer_wheel_place)
+
+namespace {
+	// Local APIC 레지스터 (xAPIC, 0xfee00000부터 memory mapped)
+	volatile uint32_t& lvt_timer = *reinterpret_cast<uint32_t*>(0xfee00320);
+	volatile uint32_t& initial_count = *reinterpret_cast<uint32_t*>(0xfee00380);
+	volatile uint32_t& current_count = *reinterpret_cast<uint32_t*>(0xfee00390);
+	volatile uint32_t& divide_config = *reinterpret_cast<uint32_t*>(0xfee003e0);
+
+	const uint32_t kCountMax = 0xffffffffu;
+	const uint32_t kDivideBy1 = 0b1011;
+	const uint32_t kLVTMasked = 1u << 16;
+	const uint32_t kLVTPeriodic = 1u << 17;
+
+	const uint32_t kCalibrationMs = 50;
+
+	uint64_t lapic_timer_freq;
+
+	char timer_wheel_buf[sizeof(TimerWheel)];
+	TimerWheel* timer_wheel;
+
+	// #@@range_begin(measure_lapic_timer)
+	// PIT가 kCalibrationMs를 세는 동안 Local APIC timer가 센 수 -> 1초당 count
+	uint64_t MeasureLAPICTimerFrequency() {
+		pit::Arm(kCalibrationMs);
+		divide_config = kDivideBy1;
+		lvt_timer = kLVTMasked | InterruptVector::kLAPICTimer; // one-shot, interrupt X
+		initial_count = kCountMax;
+		pit::Start();
+		pit::Wait();
+		const uint32_t elapsed = kCountMax - current_count;
+		initial_count = 0;
+		return static_cast<uint64_t>(elapsed) * 1000 / kCalibrationMs;
+	}
+	// #@@range_end(measure_lapic_timer)
+
+	// 만료 -> main_queue (interrupt handler 안 = main_queue의 생산자)
+	bool PostTimeout(uint64_t timeout, int value) {
+		Message msg{};
+		msg.type = Message::kTimerTimeout;
+		msg.arg.timer.timeout = timeout;
+		msg.arg.timer.value = value;
+		return !PostMessage(msg);
+	}
+
+	/* 범위 동안 interrupt 금지, 끝나면 들어올 때의 IF로 되돌림
+	(boot 중, handler 안처럼 이미 cli 상태에서 불려도 interrupt를 허용하지 않음) */
+	class InterruptGuard {
+	 public:
+		InterruptGuard() {
+			__asm__ volatile("pushfq\n\tpopq %0\n\tcli" : "=r"(rflags_) : : "memory");
+		}
+		~InterruptGuard() {
+			if (rflags_ & kRFLAGSInterruptEnable) {
+				__asm__ volatile("sti" : : : "memory");
+			}
+		}
+		InterruptGuard(const InterruptGuard&) = delete;
+		InterruptGuard& operator=(const InterruptGuard&) = delete;
+
+	 private:
+		static const uint64_t kRFLAGSInterruptEnable = 1u << 9;
+		uint64_t rflags_;
+	};
+}
+
+// #@@range_begin(lapic_timer_init)
+void InitializeLAPICTimer() {
+	timer_wheel = new(timer_wheel_buf) TimerWheel{PostTimeout};
+	lapic_timer_freq = MeasureLAPICTimerFrequency();
+
+	divide_config = kDivideBy1;
+	lvt_timer = kLVTPeriodic | InterruptVector::kLAPICTimer;
+	initial_count = lapic_timer_freq / kTimerFrequency;
+}
+
+uint64_t LAPICTimerFrequency() {
+	return lapic_timer_freq;
+}
+
+void LAPICTimerOnInterrupt() {
+	timer_wheel->Tick();
+}
+// #@@range_end(lapic_timer_init)
+
+// #@@range_begin(timer_api)
+WithError<TimerID> AddTimer(uint64_t timeout, int value) {
+	InterruptGuard guard;
+	return timer_wheel->Add(timeout, value);
+}
+
+bool CancelTimer(TimerID id) {
+	InterruptGuard guard;
+	return timer_wheel->Cancel(id);
+}
+
+uint64_t CurrentTick() {
+	return timer_wheel->CurrentTick();
+}
+// #@@range_end(timer_api)
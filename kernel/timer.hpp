@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "error.hpp"
+
+// #@@range_begin(timer_id)
+/* TimerWheel::Add가 돌려주는 timer 식별자: 하위 16bit = pool 자리 번호, 상위 16bit = 그 자리의 세대
+만료, 취소로 자리가 재사용된 뒤에는 옛 ID로 Cancel해도 아무 일 X */
+using TimerID = uint32_t;
+const TimerID kNoTimer = 0; // 세대는 1부터 -> 어떤 timer와도 같지 않음
+// #@@range_end(timer_id)
+
+// #@@range_begin(timer_wheel)
+/* 계층형 timer wheel: 64칸 x 4단 (칸 하나 = 1, 64, 4096, 262144 tick)
+timer는 만료까지 남은 tick에 맞는 단의 칸 (이중 연결 리스트)에 들어가고,
+상위 단의 칸은 그 구간이 시작되는 tick에 하위 단으로 다시 나눠 넣음 (cascade)
+Add, Cancel은 O(1), Tick은 칸이 비어 있으면 bit 검사뿐 -> 대기 중인 timer가 수천 개여도 평소 비용 X
+노드는 고정 크기 pool (heap X), 2^24 tick보다 먼 timer는 최상위 단을 돌 때마다 다시 배치 */
+class TimerWheel {
+ public:
+	static const int kLevels = 4;
+	static const int kSlotBits = 6;
+	static const int kSlots = 1 << kSlotBits;
+	static const int kMaxTimers = 4096;
+
+	/* 만료된 timer 전달 (timeout = 요청한 만료 tick), 전달할 수 없으면 (queue가 가득 참 등) false
+	-> 그 timer는 다음 tick에 다시 시도 */
+	using ExpireFunc = bool (*)(uint64_t timeout, int value);
+
+	explicit TimerWheel(ExpireFunc expire);
+	// timeout (절대 tick)에 만료, 이미 지난 tick이면 다음 Tick에 만료, pool이 가득 차면 kFull
+	WithError<TimerID> Add(uint64_t timeout, int value);
+	// 아직 만료되지 않은 timer면 취소하고 true
+	bool Cancel(TimerID id);
+	// 1 tick 진행: 이번 tick에 시작하는 상위 단의 칸을 cascade하고, 만료된 timer를 ExpireFunc로 전달
+	void Tick();
+
+	uint64_t CurrentTick() const { return tick_.load(std::memory_order_relaxed); }
+	int Pending() const { return pending_; }
+
+ private:
+	static const int32_t kNil = -1;
+
+	struct Node {
+		uint64_t timeout;
+		int value;
+		uint16_t generation;
+		int16_t slot; // level * kSlots + 칸 번호, kNil = 대기 중 X (pool의 빈 자리)
+		int32_t prev, next; // 같은 칸의 앞뒤 (빈 자리면 next = 다음 빈 자리)
+	};
+
+	// earliest 이후 (timeout이 더 이르면 earliest)에 만료되도록 알맞은 칸에 넣음
+	void Place(int32_t index, uint64_t earliest);
+	void Unlink(int32_t index);
+	void Free(int32_t index);
+	// level 단의 칸 slot 안의 timer를 떼어 내서 리스트의 첫 노드를 반환
+	int32_t Detach(int level, int slot);
+
+	ExpireFunc expire_;
+	std::atomic<uint64_t> tick_{0}; // Tick (interrupt handler)만 증가
+	int pending_ = 0;
+	int32_t free_head_ = 0;
+	int32_t heads_[kLevels * kSlots];
+	uint64_t occupied_[kLevels] = {}; // 단마다 비어 있지 않은 칸의 bit
+	Node nodes_[kMaxTimers];
+};
+// #@@range_end(timer_wheel)
+
+// #@@range_begin(lapic_timer)
+const int kTimerFrequency = 100; // 1초당 tick 수 (1 tick = 10ms)
+
+/* Local APIC timer를 PIT (channel 2)로 보정하고 kTimerFrequency 주기로 시작
+만료된 timer는 main_queue에 kTimerTimeout Message로 전달 (IDT, main_queue 설정 후 호출, 보정에 약 50ms) */
+void InitializeLAPICTimer();
+// 보정으로 구한 Local APIC timer의 count 속도 (Hz, 분주 1)
+uint64_t LAPICTimerFrequency();
+// Local APIC timer interrupt handler에서 호출
+void LAPICTimerOnInterrupt();
+
+/* 잠시 interrupt를 막아 handler의 Tick과 겹치지 않게 함 (끝나면 호출 전의 IF로 되돌림 -> cli 상태에서도 호출 가능)
+timeout은 절대 tick (CurrentTick() + n) */
+WithError<TimerID> AddTimer(uint64_t timeout, int value);
+bool CancelTimer(TimerID id);
+uint64_t CurrentTick();
+// #@@range_end(lapic_timer)
@@ -0,0 +1,43 @@
+#include "trace.hpp"
+
+#include <cpuid.h>
+
+#include "asmfunc.h"
+#include "logger.hpp"
+#include "tsc.hpp"
+
+TraceBuffer trace_buffers[kTraceMaxCPUs];
+bool trace_use_rdtscp = false;
+
+namespace {
+	const uint32_t kIA32TscAux = 0xc0000103;
+	const uint32_t kCpuidRdtscp = 1u << 27; // CPUID 0x80000001 EDX
+
+	bool CpuSupportsRdtscp() {
+		unsigned int eax, ebx, ecx, edx;
+		if (!__get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx)) {
+			return false;
+		}
+		return edx & kCpuidRdtscp;
+	}
+}
+
+// #@@range_begin(trace_init)
+void InitializeTrace(uint32_t cpu) {
+	for (auto& buffer : trace_buffers) {
+		buffer.magic = TraceBuffer::kMagic;
+	}
+	if (CpuSupportsRdtscp()) {
+		WriteMSR(kIA32TscAux, cpu);
+		trace_use_rdtscp = true;
+	}
+}
+
+void LogTraceDumpCommand() {
+	// 커널은 identity mapping이므로 변수 주소 = 물리 주소
+	Log(kWarn, "trace: (qemu) pmemsave 0x%lx %lu trace.bin\n",
+	    reinterpret_cast<uintptr_t>(trace_buffers), sizeof(trace_buffers));
+	// 보정한 TSC 주파수를 넘기면 시각을 us로 표시
+	Log(kWarn, "trace: tools/tracedecode.py kernel/kernel.elf trace.bin --tsc-hz %lu\n", TSCFrequency());
+}
+// #@@range_end(trace_init)
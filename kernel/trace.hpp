@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/* 이진 trace: 고빈도 경로 (interrupt handler, xHCI 이벤트 처리 등)용
+문자열 포맷 X -> format 문자열의 주소, TSC, 인자 원본 (최대 4개)만 CPU별 ring에 기록
+format 문자열은 kernel.elf의 .rodata에 그대로 있으므로 포맷은 host에서
+	(메모리 덤프 + kernel.elf -> tools/tracedecode.py) */
+
+// #@@range_begin(trace_buffer)
+struct TraceRecord {
+	uint64_t seq; // 기록이 끝난 순번 + 1 (0: 빈 slot 또는 쓰는 중)
+	uint64_t tsc;
+	const char* format;
+	uint64_t args[4];
+};
+
+struct TraceBuffer {
+	static const uint64_t kMagic = 0x3130454341525454; // "TTRACE01"
+	static const size_t kRecords = 4096; // 2의 거듭제곱, 가득 차면 가장 오래된 기록부터 덮어씀
+
+	uint64_t magic;
+	std::atomic<uint64_t> next; // 다음 기록의 순번
+	TraceRecord records[kRecords];
+};
+
+// CPU 번호 (IA32_TSC_AUX, InitializeTrace에서 설정)마다 1개
+const int kTraceMaxCPUs = 4;
+extern TraceBuffer trace_buffers[kTraceMaxCPUs];
+// #@@range_end(trace_buffer)
+
+// #@@range_begin(trace_init)
+/* buffer 초기화, rdtscp가 있으면 이 CPU의 TSC_AUX에 cpu 번호 설정
+(rdtscp 1회로 TSC와 CPU 번호를 함께 얻음, 없으면 모두 cpu 0의 ring에 기록) */
+void InitializeTrace(uint32_t cpu);
+// QEMU monitor에서 buffer를 파일로 저장하는 명령을 log로 출력 (pmemsave)
+void LogTraceDumpCommand();
+// #@@range_end(trace_init)
+
+// #@@range_begin(trace_record)
+extern bool trace_use_rdtscp;
+
+template <typename T>
+uint64_t TraceArg(T value) {
+	if constexpr (std::is_pointer_v<T>) {
+		return reinterpret_cast<uintptr_t>(value);
+	} else {
+		static_assert(std::is_integral_v<T> || std::is_enum_v<T>,
+		              "trace 인자는 정수, enum, 포인터만 (문자열은 .rodata에 있는 것만 복원 가능)");
+		return static_cast<uint64_t>(value); // 부호 있는 정수는 부호 확장
+	}
+}
+
+/* 예약 (같은 CPU의 interrupt가 끼어들어도 fetch_add라 slot이 겹치지 않음)
+-> seq를 0으로 -> 내용 -> seq 순서로 기록: 쓰는 도중의 slot은 decoder가 건너뜀 */
+template <typename... Args>
+inline void TraceEvent(const char* format, Args... args) {
+	static_assert(sizeof...(Args) <= 4, "trace 인자는 4개까지");
+	uint64_t tsc;
+	uint32_t cpu = 0;
+	if (trace_use_rdtscp) {
+		tsc = __builtin_ia32_rdtscp(&cpu);
+	} else {
+		tsc = __builtin_ia32_rdtsc();
+	}
+	TraceBuffer& buffer = trace_buffers[cpu % kTraceMaxCPUs];
+	const uint64_t seq = buffer.next.fetch_add(1, std::memory_order_relaxed);
+	TraceRecord& record = buffer.records[seq % TraceBuffer::kRecords];
+	record.seq = 0;
+	std::atomic_signal_fence(std::memory_order_seq_cst);
+	record.tsc = tsc;
+	record.format = format;
+	const uint64_t values[] = {TraceArg(args)..., 0};
+	for (size_t i = 0; i < sizeof...(Args); ++i) {
+		record.args[i] = values[i];
+	}
+	std::atomic_signal_fence(std::memory_order_seq_cst);
+	record.seq = seq + 1;
+}
+
+/* TRACE("xhci: %s, slot %u", name, slot_id)
+format은 문자열 리터럴만 ("" 연결로 강제), 변환은 printf 형식 (%d %u %x %lx %p %s %c) */
+#define TRACE(format, ...) TraceEvent("" format, ##__VA_ARGS__)
+// #@@range_end(trace_record)
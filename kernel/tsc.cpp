@@ -0,0 +1,130 @@
+#include "tsc.hpp"
+
+#include <cpuid.h>
+
+#include "logger.hpp"
+#include "pit.hpp"
+#include "timer.hpp"
+
+uint64_t tsc_ns_mult;
+
+namespace {
+	const uint32_t kCpuidInvariantTSC = 1u << 8; // CPUID 0x80000007 EDX
+	const uint32_t kCalibrationMs = 50;
+	const uint64_t kNsPerSecond = 1000000000;
+	// PIT로 잰 값을 믿을 수 있는 범위
+	const uint64_t kMinFrequency = 10000000; // 10MHz
+	const uint64_t kMaxFrequency = 20000000000; // 20GHz
+	const uint64_t kFallbackFrequency = 1000000000; // 1GHz
+
+	bool tsc_invariant;
+	uint64_t tsc_freq;
+	uint64_t tsc_cycles_mult; // cycle = ns * tsc_cycles_mult >> 32
+
+	bool CpuHasInvariantTSC() {
+		unsigned int eax, ebx, ecx, edx;
+		if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007) {
+			return false;
+		}
+		__cpuid(0x80000007, eax, ebx, ecx, edx);
+		return edx & kCpuidInvariantTSC;
+	}
+
+	// CPUID 0x16 EAX: processor base frequency (MHz), 지원하지 않으면 0
+	uint64_t CpuBaseFrequency() {
+		unsigned int eax, ebx, ecx, edx;
+		if (__get_cpuid_max(0, nullptr) < 0x16) {
+			return 0;
+		}
+		__cpuid(0x16, eax, ebx, ecx, edx);
+		return static_cast<uint64_t>(eax & 0xffff) * 1000000;
+	}
+}
+
+// #@@range_begin(tsc_init)
+Error InitializeTSC() {
+	tsc_invariant = CpuHasInvariantTSC();
+
+	pit::Arm(kCalibrationMs);
+	pit::Start();
+	const uint64_t start = Now();
+	pit::Wait();
+	tsc_freq = Elapsed(start) * 1000 / kCalibrationMs;
+
+	Error err = MAKE_ERROR(Error::kSuccess);
+	if (tsc_freq < kMinFrequency || tsc_freq > kMaxFrequency) {
+		err = MAKE_ERROR(Error::kCalibrationFailed);
+		tsc_freq = CpuBaseFrequency();
+		if (tsc_freq < kMinFrequency || tsc_freq > kMaxFrequency) {
+			tsc_freq = kFallbackFrequency;
+		}
+	}
+
+	// 2^32배 한 환산 계수 (주파수 < 4.3GHz 가정 X: 몫과 나머지로 나눠 계산)
+	tsc_ns_mult = (kNsPerSecond << 32) / tsc_freq;
+	tsc_cycles_mult = (tsc_freq / kNsPerSecond << 32) + ((tsc_freq % kNsPerSecond) << 32) / kNsPerSecond;
+	return err;
+}
+
+bool TSCInvariant() {
+	return tsc_invariant;
+}
+
+uint64_t TSCFrequency() {
+	return tsc_freq;
+}
+
+uint64_t NsToCycles(uint64_t ns) {
+	return static_cast<unsigned __int128>(ns) * tsc_cycles_mult >> 32;
+}
+// #@@range_end(tsc_init)
+
+// #@@range_begin(tsc_drift)
+namespace {
+	// CurrentTick()이 until 이상이 될 때까지 대기, TSC로 deadline을 넘으면 false
+	// (hlt X: timer가 멈춰 있으면 깨워 줄 interrupt가 없을 수 있음)
+	bool WaitForTick(uint64_t until, uint64_t deadline) {
+		while (CurrentTick() < until) {
+			if (Now() > deadline) {
+				return false;
+			}
+			__asm__("pause");
+		}
+		return true;
+	}
+}
+
+int64_t CheckTSCDrift(int ticks) {
+	if (LAPICTimerFrequency() == 0) {
+		LogAs(kLogKernel, kWarn, "tsc: LAPIC timer is not calibrated, drift check skipped\n");
+		return 0;
+	}
+	// 다음 tick 경계 대기 (최대 1 tick) + 측정 (ticks) -> 그 2배까지 기다림
+	const uint64_t deadline = Now() + NsToCycles(2 * (ticks + 1) * kNsPerSecond / kTimerFrequency);
+
+	// 다음 tick interrupt 직후부터 재기 (양쪽 끝 모두 handler 직후 -> 지연이 상쇄됨)
+	const uint64_t start_tick = CurrentTick() + 1;
+	if (!WaitForTick(start_tick, deadline)) {
+		LogAs(kLogKernel, kWarn, "tsc: LAPIC timer is not ticking, drift check skipped\n");
+		return 0;
+	}
+	const uint64_t start = Now();
+	if (!WaitForTick(start_tick + ticks, deadline)) {
+		LogAs(kLogKernel, kWarn, "tsc: LAPIC timer is not ticking, drift check skipped\n");
+		return 0;
+	}
+	const uint64_t tsc_ns = ElapsedNs(start);
+	const uint64_t apic_ns = (CurrentTick() - start_tick) * kNsPerSecond / kTimerFrequency;
+
+	const int64_t drift_ppm = (static_cast<int64_t>(tsc_ns) - static_cast<int64_t>(apic_ns)) * 1000000
+	                        / static_cast<int64_t>(apic_ns);
+	if (drift_ppm > kMaxDriftPPM || drift_ppm < -kMaxDriftPPM) {
+		LogAs(kLogKernel, kWarn, "tsc: %lu ns by TSC vs %lu ns by LAPIC timer, drift %ld ppm\n",
+		      tsc_ns, apic_ns, drift_ppm);
+	} else {
+		LogAs(kLogKernel, kInfo, "tsc: %lu ns by TSC vs %lu ns by LAPIC timer, drift %ld ppm\n",
+		      tsc_ns, apic_ns, drift_ppm);
+	}
+	return drift_ppm;
+}
+// #@@range_end(tsc_drift)
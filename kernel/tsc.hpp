@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+
+#include "error.hpp"
+
+// #@@range_begin(tsc_clock)
+/* 고해상도 단조 시계: TSC (rdtsc 1회, port I/O X) + 부팅 때 PIT로 보정한 주파수
+구간 측정: const uint64_t start = Now(); ...; Elapsed(start) (cycle), ElapsedNs(start) (ns)
+invariant TSC (CPUID 0x80000007 EDX bit 8)가 아니면 P-state 등으로 속도가 바뀔 수 있음 -> ns 값은 참고용
+PIT로 잰 주파수가 0이거나 터무니없으면 (PIT channel 2 gate 고장 등) kCalibrationFailed
+-> CPUID 0x16의 기준 주파수, 그것도 없으면 kFallbackFrequency로 대신함 (ns 값은 어림값) */
+Error InitializeTSC();
+bool TSCInvariant();
+uint64_t TSCFrequency(); // Hz, InitializeTSC 전에는 0
+
+extern uint64_t tsc_ns_mult; // ns = cycle * tsc_ns_mult >> 32 (InitializeTSC 전에는 0)
+
+inline uint64_t Now() {
+	return __builtin_ia32_rdtsc();
+}
+
+inline uint64_t Elapsed(uint64_t start) {
+	return Now() - start;
+}
+
+// 곱셈 1회 (나눗셈 X), 128bit 곱이라 부팅 후 수백 년까지 넘치지 않음
+inline uint64_t CyclesToNs(uint64_t cycles) {
+	return static_cast<unsigned __int128>(cycles) * tsc_ns_mult >> 32;
+}
+
+inline uint64_t NowNs() {
+	return CyclesToNs(Now());
+}
+
+inline uint64_t ElapsedNs(uint64_t start) {
+	return CyclesToNs(Elapsed(start));
+}
+
+uint64_t NsToCycles(uint64_t ns);
+// #@@range_end(tsc_clock)
+
+// #@@range_begin(tsc_drift)
+/* 자체 점검: LAPIC timer ticks tick 동안을 TSC로 재서 차이 (ppm)를 log로 (kMaxDriftPPM 초과면 kWarn)
+둘 다 PIT로 보정했으므로 차이 = 보정 오차 + 두 시계의 속도 차이 (QEMU에서는 host 부하 영향도 큼)
+LAPIC timer 시작, sti 이후 호출 (tick 경계부터 재기 위해 대기 -> ticks / kTimerFrequency초 걸림)
+LAPIC timer 보정에 실패했거나 예상 시간의 2배 안에 tick이 진행하지 않으면 (interrupt mask 등) 검사하지 않고 0 */
+const int64_t kMaxDriftPPM = 1000;
+int64_t CheckTSCDrift(int ticks);
+// #@@range_end(tsc_drift)
@@ -1,3 +1,5 @@
+#define LOG_SUBSYSTEM kLogHID
+
 #include "usb/classdriver/mouse.hpp"
 
 #include <algorithm>
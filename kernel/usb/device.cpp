@@ -1,3 +1,5 @@
+#define LOG_SUBSYSTEM kLogUSB
+
 #include "usb/device.hpp"
 
 #include "usb/descriptor.hpp"
@@ -73,30 +75,30 @@ namespace {
     return nullptr;
   }
 
-  void Log(LogLevel level, const usb::InterfaceDescriptor& if_desc) {
-    Log(level, "Interface Descriptor: class=%d, sub=%d, protocol=%d\n",
+  void LogMessage(LogLevel level, const usb::InterfaceDescriptor& if_desc) {
+    LogMessage(level, "Interface Descriptor: class=%d, sub=%d, protocol=%d\n",
         if_desc.interface_class,
         if_desc.interface_sub_class,
         if_desc.interface_protocol);
   }
 
-  void Log(LogLevel level, const usb::EndpointConfig& conf) {
-    Log(level, "EndpointConf: ep_id=%d, ep_type=%d"
+  void LogMessage(LogLevel level, const usb::EndpointConfig& conf) {
+    LogMessage(level, "EndpointConf: ep_id=%d, ep_type=%d"
         ", max_packet_size=%d, interval=%d\n",
-        conf.ep_id.Address(), conf.ep_type,
+        conf.ep_id.Address(), static_cast<int>(conf.ep_type),
         conf.max_packet_size, conf.interval);
   }
 
-  void Log(LogLevel level, const usb::HIDDescriptor& hid_desc) {
-    Log(level, "HID Descriptor: release=0x%02x, num_desc=%d",
+  void LogMessage(LogLevel level, const usb::HIDDescriptor& hid_desc) {
+    LogMessage(level, "HID Descriptor: release=0x%02x, num_desc=%d",
         hid_desc.hid_release,
         hid_desc.num_descriptors);
     for (int i = 0; i < hid_desc.num_descriptors; ++i) {
-      Log(level, ", desc_type=%d, len=%d",
+      LogMessage(level, ", desc_type=%d, len=%d",
           hid_desc.GetClassDescriptor(i)->descriptor_type,
           hid_desc.GetClassDescriptor(i)->descriptor_length);
     }
-    Log(level, "\n");
+    LogMessage(level, "\n");
   }
 }
 
@@ -148,7 +150,7 @@ namespace usb {
 
   Error Device::OnControlCompleted(EndpointID ep_id, SetupData setup_data,
                                    const void* buf, int len) {
-    Log(kDebug, "Device::OnControlCompleted: buf 0x%08x, len %d, dir %d\n",
+    Log(kDebug, "Device::OnControlCompleted: buf %p, len %d, dir %d\n",
         buf, len, setup_data.request_type.bits.direction);
     if (is_initialized_) {
       if (auto w = event_waiters_.Get(setup_data)) {
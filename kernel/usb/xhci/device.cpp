@@ -1,3 +1,5 @@
+#define LOG_SUBSYSTEM kLogXHCI
+
 #include "usb/xhci/device.hpp"
 
 #include "logger.hpp"
@@ -27,8 +29,8 @@ namespace {
     return data;
   }
 
-  void Log(LogLevel level, const DataStageTRB& trb) {
-    Log(level,
+  void LogMessage(LogLevel level, const DataStageTRB& trb) {
+    LogMessage(level,
         "DataStageTRB: len %d, buf 0x%08lx, dir %d, attr 0x%02x\n",
         trb.bits.trb_transfer_length,
         trb.bits.data_buffer_pointer,
@@ -36,8 +38,8 @@ namespace {
         trb.data[3] & 0x7fu);
   }
 
-  void Log(LogLevel level, const SetupStageTRB& trb) {
-    Log(level,
+  void LogMessage(LogLevel level, const SetupStageTRB& trb) {
+    LogMessage(level,
         "  SetupStage TRB: req_type %02x, req %02x, val %02x, ind %02x, len %02x\n",
         trb.bits.request_type,
         trb.bits.request,
@@ -46,9 +48,9 @@ namespace {
         trb.bits.length);
   }
 
-  void Log(LogLevel level, const TransferEventTRB& trb) {
+  void LogMessage(LogLevel level, const TransferEventTRB& trb) {
     if (trb.bits.event_data) {
-      Log(level,
+      LogMessage(level,
           "Transfer (value %08lx) completed: %s, residual length %d, slot %d, ep addr %d\n",
           reinterpret_cast<uint64_t>(trb.Pointer()),
           kTRBCompletionCodeToName[trb.bits.completion_code],
@@ -59,7 +61,7 @@ namespace {
     }
 
     TRB* issuer_trb = trb.Pointer();
-    Log(level,
+    LogMessage(level,
         "%s completed: %s, residual length %d, slot %d, ep addr %d\n",
         kTRBTypeToName[issuer_trb->bits.trb_type],
         kTRBCompletionCodeToName[trb.bits.completion_code],
@@ -67,11 +69,11 @@ namespace {
         trb.bits.slot_id,
         trb.EndpointID().Address());
     if (auto data_trb = TRBDynamicCast<DataStageTRB>(issuer_trb)) {
-      Log(level, "  ");
-      Log(level, *data_trb);
+      LogMessage(level, "  ");
+      LogMessage(level, *data_trb);
     } else if (auto setup_trb = TRBDynamicCast<SetupStageTRB>(issuer_trb)) {
-      Log(level, "  ");
-      Log(level, *setup_trb);
+      LogMessage(level, "  ");
+      LogMessage(level, *setup_trb);
     }
   }
 }
@@ -110,7 +112,7 @@ namespace usb::xhci {
       return err;
     }
 
-    Log(kDebug, "Device::ControlIn: ep addr %d, buf 0x%08x, len %d\n",
+    Log(kDebug, "Device::ControlIn: ep addr %d, buf %p, len %d\n",
         ep_id.Address(), buf, len);
     if (ep_id.Number() < 0 || 15 < ep_id.Number()) {
       return MAKE_ERROR(Error::kInvalidEndpointNumber);
@@ -157,7 +159,7 @@ namespace usb::xhci {
       return err;
     }
 
-    Log(kDebug, "Device::ControlOut: ep addr %d, buf 0x%08x, len %d\n",
+    Log(kDebug, "Device::ControlOut: ep addr %d, buf %p, len %d\n",
         ep_id.Address(), buf, len);
     if (ep_id.Number() < 0 || 15 < ep_id.Number()) {
       return MAKE_ERROR(Error::kInvalidEndpointNumber);
@@ -227,7 +229,7 @@ namespace usb::xhci {
       return err;
     }
 
-    Log(kDebug, "Device::InterrutpOut: ep addr %d, buf %08lx, len %d, dev %08lx\n",
+    Log(kDebug, "Device::InterrutpOut: ep addr %d, buf %p, len %d, dev %p\n",
         ep_id.Address(), buf, len, this);
     return MAKE_ERROR(Error::kNotImplemented);
   }
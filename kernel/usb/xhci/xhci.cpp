@@ -1,6 +1,9 @@
+#define LOG_SUBSYSTEM kLogXHCI
+
 #include "usb/xhci/xhci.hpp"
 
 #include "logger.hpp"
+#include "trace.hpp"
 #include "usb/setupdata.hpp"
 #include "usb/device.hpp"
 #include "usb/descriptor.hpp"
@@ -484,6 +487,10 @@ namespace usb::xhci {
 
     Error err = MAKE_ERROR(Error::kNotImplemented);
     auto event_trb = xhc.PrimaryEventRing()->Front();
+    // event TRB 공통: completion code = dword 2의 bit 24~31, slot = dword 3의 bit 24~31
+    TRACE("xhci: %s, slot %u, completion code %u",
+          kTRBTypeToName[event_trb->bits.trb_type], event_trb->data[3] >> 24,
+          event_trb->data[2] >> 24);
     if (auto trb = TRBDynamicCast<TransferEventTRB>(event_trb)) {
       err = OnEvent(xhc, *trb);
     } else if (auto trb = TRBDynamicCast<PortStatusChangeEventTRB>(event_trb)) {
@@ -0,0 +1,44 @@
+#include "window.hpp"
+
+// #@@range_begin(window_init)
+Error Window::Initialize(int width, int height, PixelFormat pixel_format) {
+	uint8_t* buf = AllocGraphicsMemory(4 * static_cast<size_t>(width) * height);
+	if (buf == nullptr) {
+		return MAKE_ERROR(Error::kNoEnoughMemory);
+	}
+
+	width_ = width;
+	height_ = height;
+	config_.frame_buffer = buf;
+	config_.pixels_per_scan_line = width;
+	config_.horizontal_resolution = width;
+	config_.vertical_resolution = height;
+	config_.pixel_format = pixel_format;
+
+	writer_ = NewPixelWriter(writer_storage_, config_, false);
+	if (writer_ == nullptr) {
+		return MAKE_ERROR(Error::kUnknownPixelFormat);
+	}
+	return MAKE_ERROR(Error::kSuccess);
+}
+// #@@range_end(window_init)
+
+void Window::SetTransparentColor(const PixelColor& c) {
+	has_transparent_color_ = true;
+	transparent_color_ = EncodePixel(config_.pixel_format, c);
+}
+
+// #@@range_begin(window_drawto)
+void Window::DrawTo(FrameBuffer& screen, Vector2D<int> pos, const Rectangle<int>& area) const {
+	const Rectangle<int> rect = Rectangle<int>{pos, {width_, height_}} & area;
+	if (IsEmpty(rect)) {
+		return;
+	}
+	render_counters.composite_pixels += static_cast<uint64_t>(rect.size.x) * rect.size.y;
+	// 화면 밖 잘라내기, damage 기록, VRAM이면 non-temporal store는 모두 BitBlt가 처리
+	const ImageView image{reinterpret_cast<const uint32_t*>(config_.frame_buffer),
+	                      width_, height_, width_};
+	screen.Writer().BitBlt(rect.pos, image, {{rect.pos.x - pos.x, rect.pos.y - pos.y}, rect.size},
+		has_transparent_color_ ? BlitMode::kColorKey : BlitMode::kOpaque, transparent_color_);
+}
+// #@@range_end(window_drawto)
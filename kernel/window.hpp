@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+#include "error.hpp"
+#include "frame_buffer.hpp"
+#include "graphics.hpp"
+
+/* Window: layer 1개가 소유하는 픽셀 버퍼
+화면과 같은 픽셀 포맷으로 보관 -> 합성 시 포맷 변환 없이 행 단위 복사만으로 끝남 */
+class Window {
+ public:
+	// 버퍼는 graphics memory에서 확보 (해제 X)
+	Error Initialize(int width, int height, PixelFormat pixel_format);
+
+	PixelWriter& Writer() { return *writer_; }
+	int Width() const { return width_; }
+	int Height() const { return height_; }
+
+	// 투명색으로 지정된 픽셀은 합성 시 아래 layer가 그대로 보임 (마우스 커서 등)
+	void SetTransparentColor(const PixelColor& c);
+	// 투명색이 없으면 아래 layer를 완전히 가림
+	bool IsOpaque() const { return !has_transparent_color_; }
+
+	/* 화면 좌표 pos에 놓인 이 window 중, 화면 좌표 area에 해당하는 부분만 screen에 복사
+	(area, 화면 범위 밖은 잘라냄) */
+	void DrawTo(FrameBuffer& screen, Vector2D<int> pos, const Rectangle<int>& area) const;
+
+ private:
+	int width_ = 0, height_ = 0;
+	FrameBufferConfig config_{};
+	PixelWriterStorage writer_storage_;
+	PixelWriter* writer_ = nullptr;
+	bool has_transparent_color_ = false;
+	uint32_t transparent_color_ = 0; // 버퍼와 같은 포맷으로 encode한 값
+};
@@ -1,40 +1,162 @@
 #!/usr/bin/python3
 
+"""글꼴 소스 (.txt 비트맵, BDF)를 커널의 다중 페이지 글꼴 파일로 변환
+
+출력 형식 (little endian):
+  header   magic 'KFN1', u16 페이지 수, u16 0, u32 글자 수, u32 0
+  level 1  u16 x 256: code point 상위 8bit -> 페이지 번호 (0xffff = 없음)
+  level 2  페이지마다 u16 x 256: code point 하위 8bit -> 글자 번호 (0xffff = 없음)
+  width    u8 x 글자 수: 8 (반각) 또는 16 (전각)
+  bitmap   글자마다 32바이트: 16행, 행마다 (폭 + 7) / 8 바이트 (MSB가 왼쪽 픽셀)
+BMP (U+0000 - U+FFFF)만 수록
+"""
+
 import argparse
-import collections
-import functools
 import re
-import sys
+import struct
 
 
 BITMAP_PATTERN = re.compile(r'([.*@]+)')
+CODE_PATTERN = re.compile(r'0x([0-9a-fA-F]+)')
+HEIGHT = 16
+GLYPH_BYTES = 32
+NO_ENTRY = 0xffff
 
 
-def compile(src: str) -> bytes:
-    src = src.lstrip()
-    result = []
+def compile_text(src: str) -> dict:
+    """0xNN 줄 다음에 16행 비트맵 ('.' = 0, '*'/'@' = 1), 행 길이 8 또는 16"""
+    glyphs = {}
+    code, rows = None, []
 
     for line in src.splitlines():
+        m = CODE_PATTERN.match(line)
+        if m:
+            code, rows = int(m.group(1), 16), []
+            continue
         m = BITMAP_PATTERN.match(line)
-        if not m:
+        if not m or code is None:
+            continue
+
+        bits = m.group(1)
+        rows.append(int(bits.replace('.', '0').replace('*', '1').replace('@', '1'), 2))
+        if len(rows) == HEIGHT:
+            glyphs.setdefault(code, (len(bits), rows))
+            code = None
+
+    return glyphs
+
+
+def compile_bdf(src: str, ranges) -> dict:
+    """BDF의 글자를 16픽셀 높이 칸에 baseline (FONT_ASCENT)을 맞춰 배치
+    DWIDTH가 8 이하면 반각, 16 이하면 전각, 그보다 넓은 글자는 제외"""
+    glyphs = {}
+    ascent = HEIGHT - 2
+    code, width, bbx, rows = None, 8, (0, 0, 0, 0), None
+
+    for line in src.splitlines():
+        words = line.split()
+        if not words:
+            continue
+        key = words[0]
+        if key == 'FONT_ASCENT':
+            ascent = int(words[1])
+        elif key == 'STARTCHAR':
+            code, width, bbx, rows = None, 8, (0, 0, 0, 0), None
+        elif key == 'ENCODING':
+            code = int(words[1])
+        elif key == 'DWIDTH':
+            width = int(words[1])
+        elif key == 'BBX':
+            bbx = tuple(int(w) for w in words[1:5])
+        elif key == 'BITMAP':
+            rows = []
+        elif key == 'ENDCHAR':
+            if (code is not None and 0 <= code <= 0xffff and width <= 16
+                    and any(lo <= code <= hi for lo, hi in ranges)):
+                glyphs.setdefault(code, place_bdf_glyph(width, bbx, rows, ascent))
+            rows = None
+        elif rows is not None:
+            rows.append(line.strip())
+
+    return glyphs
+
+
+def place_bdf_glyph(width: int, bbx, hex_rows, ascent: int):
+    cell_width = 8 if width <= 8 else 16
+    w, h, x_offset, y_offset = bbx
+    top = ascent - (y_offset + h)  # 칸 맨 위에서 bbx 맨 위까지
+    rows = [0] * HEIGHT
+
+    for i, hex_row in enumerate(hex_rows[:h]):
+        y = top + i
+        if not 0 <= y < HEIGHT or not hex_row:
             continue
+        bits = int(hex_row, 16)
+        row_bits = 4 * len(hex_row)
+        for x in range(w):
+            cx = x_offset + x
+            if 0 <= cx < cell_width and (bits >> (row_bits - 1 - x)) & 1:
+                rows[y] |= 1 << (cell_width - 1 - cx)
+
+    return cell_width, rows
+
 
-        bits = [(0 if x == '.' else 1) for x in m.group(1)]
-        bits_int = functools.reduce(lambda a, b: 2*a + b, bits)
-        result.append(bits_int.to_bytes(1, byteorder='little'))
+def parse_ranges(text: str):
+    ranges = []
+    for part in text.split(','):
+        lo, _, hi = part.partition('-')
+        ranges.append((int(lo, 16), int(hi or lo, 16)))
+    return ranges
 
+
+def build(glyphs: dict) -> bytes:
+    codes = sorted(glyphs)
+    page_numbers = {}
+    for code in codes:
+        page_numbers.setdefault(code >> 8, len(page_numbers))
+
+    level1 = [NO_ENTRY] * 256
+    for high, page in page_numbers.items():
+        level1[high] = page
+    level2 = [[NO_ENTRY] * 256 for _ in page_numbers]
+    widths, bitmaps = [], []
+
+    for index, code in enumerate(codes):
+        width, rows = glyphs[code]
+        level2[page_numbers[code >> 8]][code & 0xff] = index
+        widths.append(width)
+        row_bytes = (width + 7) // 8
+        bitmap = b''.join(row.to_bytes(row_bytes, byteorder='big') for row in rows)
+        bitmaps.append(bitmap.ljust(GLYPH_BYTES, b'\0'))
+
+    result = [b'KFN1', struct.pack('<HHII', len(page_numbers), 0, len(codes), 0),
+              struct.pack('<256H', *level1)]
+    result += [struct.pack('<256H', *page) for page in level2]
+    result.append(bytes(widths))
+    result += bitmaps
     return b''.join(result)
 
 
 def main():
     parser = argparse.ArgumentParser()
-    parser.add_argument('font', help='path to a font file')
+    parser.add_argument('font', nargs='+',
+                        help='path to font files (.txt or .bdf); earlier files take precedence')
     parser.add_argument('-o', help='path to an output file', default='font.out')
+    parser.add_argument('--ranges', default='0-ffff',
+                        help='code point ranges taken from BDF files (e.g. 0-7f,ac00-d7a3)')
     ns = parser.parse_args()
 
-    with open(ns.o, 'wb') as out, open(ns.font) as font:
-        src = font.read()
-        out.write(compile(src))
+    ranges = parse_ranges(ns.ranges)
+    glyphs = {}
+    for path in ns.font:
+        with open(path, encoding='utf-8', errors='replace') as font:
+            src = font.read()
+        compiled = compile_bdf(src, ranges) if path.endswith('.bdf') else compile_text(src)
+        for code, glyph in compiled.items():
+            glyphs.setdefault(code, glyph)
+
+    with open(ns.o, 'wb') as out:
+        out.write(build(glyphs))
 
 
 if __name__ == '__main__':
@@ -0,0 +1,116 @@
+#!/usr/bin/python3
+
+"""커널의 이진 trace buffer (kernel/trace.hpp) 덤프를 텍스트로 복원
+
+덤프 방법: 커널에서 F10 -> log에 나오는 QEMU monitor 명령 (pmemsave 주소 크기 trace.bin) 실행
+format 문자열과 %s 인자는 kernel.elf의 적재 segment에서 주소로 읽음
+"""
+
+import argparse
+import re
+import struct
+
+
+TRACE_MAGIC = 0x3130454341525454  # "TTRACE01"
+RECORDS = 4096
+RECORD = struct.Struct('<QQQ4Q')  # seq, tsc, format, args[4]
+HEADER = struct.Struct('<QQ')  # magic, next
+CONVERSION = re.compile(r'%([-+ #0]*\d*(?:\.\d+)?)(hh|h|ll|l|z)?([diuxXpsc%])')
+
+
+class Elf:
+    """ELF64의 PT_LOAD segment만 읽어 가상 주소 -> 바이트 변환"""
+
+    def __init__(self, path: str):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        if self.data[:4] != b'\x7fELF' or self.data[4] != 2:
+            raise ValueError(f'{path}: not an ELF64 file')
+        phoff, = struct.unpack_from('<Q', self.data, 0x20)
+        phentsize, phnum = struct.unpack_from('<HH', self.data, 0x36)
+        self.segments = []
+        for i in range(phnum):
+            p_type, _, p_offset, p_vaddr, _, p_filesz, _, _ = struct.unpack_from(
+                '<IIQQQQQQ', self.data, phoff + i * phentsize)
+            if p_type == 1:  # PT_LOAD
+                self.segments.append((p_vaddr, p_offset, p_filesz))
+
+    def string(self, addr: int):
+        for vaddr, offset, size in self.segments:
+            if vaddr <= addr < vaddr + size:
+                start = offset + addr - vaddr
+                end = self.data.find(b'\0', start, offset + size)
+                return self.data[start:end].decode('utf-8', errors='replace')
+        return None
+
+
+def format_record(elf: Elf, fmt: str, args) -> str:
+    values = iter(args)
+
+    def convert(m):
+        flags, length, conv = m.groups()
+        if conv == '%':
+            return '%'
+        value = next(values, 0)
+        if conv in 'di':
+            if length in ('l', 'll', 'z'):
+                value = value - (1 << 64) if value >> 63 else value
+            else:
+                value &= 0xffffffff
+                value = value - (1 << 32) if value >> 31 else value
+            return ('%' + flags + 'd') % value
+        if conv in 'uxX':
+            if length not in ('l', 'll', 'z'):
+                value &= 0xffffffff
+            return ('%' + flags + conv.replace('u', 'd')) % value
+        if conv == 'p':
+            return f'0x{value:x}'
+        if conv == 'c':
+            return chr(value & 0xff)
+        s = elf.string(value)  # %s: .rodata에 있는 문자열만 복원 가능
+        return s if s is not None else f'<0x{value:x}>'
+
+    return CONVERSION.sub(convert, fmt)
+
+
+def read_records(dump: bytes):
+    buffer_size = HEADER.size + RECORDS * RECORD.size
+    for cpu in range(len(dump) // buffer_size):
+        base = cpu * buffer_size
+        magic, next_seq = HEADER.unpack_from(dump, base)
+        if magic != TRACE_MAGIC:
+            continue
+        # ring에 남아 있는 순번 범위: [next - RECORDS, next), seq가 맞지 않는 slot은 쓰는 도중
+        for seq in range(max(0, next_seq - RECORDS), next_seq):
+            offset = base + HEADER.size + (seq % RECORDS) * RECORD.size
+            record_seq, tsc, fmt, *args = RECORD.unpack_from(dump, offset)
+            if record_seq == seq + 1:
+                yield cpu, tsc, fmt, args
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('elf', help='path to kernel.elf')
+    parser.add_argument('dump', help='path to a trace buffer dump (pmemsave)')
+    parser.add_argument('--tsc-hz', type=float,
+                        help='TSC frequency; prints microseconds instead of cycles')
+    ns = parser.parse_args()
+
+    elf = Elf(ns.elf)
+    with open(ns.dump, 'rb') as f:
+        dump = f.read()
+
+    records = sorted(read_records(dump), key=lambda r: r[1])
+    if not records:
+        return
+    first_tsc = records[0][1]
+    for cpu, tsc, fmt_addr, args in records:
+        fmt = elf.string(fmt_addr)
+        text = format_record(elf, fmt, args) if fmt is not None else f'<format 0x{fmt_addr:x}> {args}'
+        delta = tsc - first_tsc
+        stamp = f'{delta / ns.tsc_hz * 1e6:14.3f} us' if ns.tsc_hz else f'{delta:14d} cyc'
+        print(f'[{stamp} cpu{cpu}] {text}')
+
+
+if __name__ == '__main__':
+    main()